@@ -17,6 +17,46 @@ the LED brightness state variables. Each animation program runs in a loop. Instr
 the following format:
   [ LED brightness array -- signed integer ] [ Opcode ] [ Opcode specific operand ]
 
+The instructions are stored packed in the flash, and decoded one by one while the animation
+runs. A packed instruction is a byte stream:
+  [ Opcode ] [ Timing -- 2 bytes, little endian ] ( [ Sign bits ] ) [ Magnitudes -- 4 bits each ] ( [ Operand ] )
+The sign bits (one per value, LSB first) and the operand are only present if the
+OPCODE_EXTENDED flag is set in the opcode byte. LOAD_LEDS()/LOAD_RGB() build a plain load,
+EXEC_LEDS()/EXEC_RGB() build any other instruction. The values have to be in [-15; 15].
+A load that differs from the previous instruction in a few values only can be given by
+those values instead, with DELTA_LEDS() (the first instruction is compared to all zeros):
+  [ OPCODE_DELTA ] [ Timing -- 2 bytes ] [ Number of patches ] [ Patches -- index : magnitude, 4 bits each ]
+
+Control flow instructions take no time, they only tell the decoder where the next instruction is:
+  LOOP( count ) ... END_LOOP()   the instructions in between are decoded (count) times, at least once
+  CALL( subroutine )             the instructions of gasSubroutines[ subroutine ] are decoded, then
+                                 the ones after the call. The end of the subroutine is the return.
+  CALL_SCALED( subroutine, % )   the same, with the timings of the subroutine scaled, up to 398 % (nested scales
+                                 multiply, up to 1600 %)
+  JUMP( subroutine )             the track continues with the subroutine and ends with it
+  LAYER( subroutine, blend )     the subroutine starts to run as a layer over the track, on its own
+                                 timer and in a loop, until the animation is switched. The output is
+                                 the track and the layers merged (E_ANIMATION_BLEND). A layer already
+                                 running the subroutine is kept, so it belongs to the start of the track.
+  TRACK( subroutine, mask )      the same, but the layer owns the LEDs in the mask (LED_BIT()s) and
+                                 leaves the others to the track: independent tracks per LED group,
+                                 each with its own period and repeat state
+Loops and calls can be nested up to ANIMATION_STACK_DEPTH levels, a deeper one ends the track.
+A delta load is relative to the previously decoded instruction, even across these.
+
+Generator instructions compute the levels at runtime, see E_ANIMATION_GENERATOR. The values are
+the parameters of each LED (magnitudes only), and the instruction is repeated like REPEAT does
+(so neither of them can be the first instruction of a track, the timer can't step back from there):
+  [ OPCODE_GENERATE | Generator << 4 ] [ Timing -- 2 bytes ] [ Magnitudes ] [ Parameter ] [ Repetitions ]
+FADE_LEDS()/FADE_RGB() is a generator too: the levels are interpolated from the previous ones to the
+values during the instruction, computed in every ms along an easing curve (E_ANIMATION_EASING).
+The next instruction sees the values, as if they were loaded.
+
+The timings are in ms. With ANIMATION_TICK_TIMEBASE the machine runs on the 100 usec timer ticks
+instead: the fades are computed in every tick, and TICKS( n ) gives a timing shorter than a ms
+(the timings in ms have to be below 32768 then). Without it TICKS( n ) is rounded up to whole ms.
+Either way the LEDs change at PWM frame boundaries only, as the drivers take the commits there.
+
 ----------------------------------------------------------------------------------------*/
 
 /***************************************< Includes >**************************************/
@@ -35,6 +75,117 @@ the following format:
 
 /***************************************< Definitions >**************************************/
 #define RIGHT_LEDS_START    (6u)  //!< Index of the first LED on the right side of the board
+#define RIGHT_RGB_START     ( NUM_RGBLED_COLORS )  //!< The colors of the RGB LED have no right side, the sources flow through all of them
+#define ANIMATION_LEVEL_MAX (15u) //!< Highest brightness level in the animation tables
+#define ANIMATION_LEVEL_STEP  LED_LINEAR_STEP  //!< Logical brightness of one animation level, a distinct level on every LED driver
+#if ( ANIMATION_LEVEL_MAX + 1u ) != LED_LINEAR_LEVELS
+  #error "The animation levels have to be the linear levels of the LED drivers!"
+#endif
+#define PROGRAM_NONE        (0xFFu)  //!< No animation has been loaded to the decoders yet
+#define OPCODE_EXTENDED     (0x08u)  //!< Opcode byte flag: sign bits and operand follow
+#define OPCODE_DELTA        ( LOAD | OPCODE_EXTENDED )  //!< Opcode byte of a load given by the changed values (an extended load is never built)
+#define OPCODE_LOOP         (0x01u)  //!< Opcode byte of a loop start, operand: number of passes
+#define OPCODE_END_LOOP     (0x02u)  //!< Opcode byte of a loop end
+#define OPCODE_CALL         (0x03u)  //!< Opcode byte of a subroutine call, operands: subroutine, time scale in percent
+#define OPCODE_JUMP         (0x04u)  //!< Opcode byte of a jump to a subroutine, operand: subroutine
+#define OPCODE_LAYER        (0x05u)  //!< Opcode byte of a layer start, operands: subroutine, blend mode, LED mask (2 bytes)
+#define OPCODE_GENERATE     (0x07u)  //!< Opcode byte of a generator instruction, the generator is in the upper nibble
+//! Generator instruction
+#define IS_GENERATOR( u8Header )     ( OPCODE_GENERATE == ( (u8Header) & 0x0Fu ) )
+//! A plain opcode byte other than a load or a generator is a control flow instruction
+#define IS_CONTROL_FLOW( u8Header )  ( ( LOAD != (u8Header) ) && ( 0u == ( OPCODE_EXTENDED & (u8Header) ) ) && !IS_GENERATOR( u8Header ) )
+#define LFSR_TAPS           (0xB400u)  //!< Feedback of the 16 bit Galois LFSR, maximal length
+#define FADE_PROGRESS_MAX   (256u)     //!< Progress of a finished fade
+#define ANIMATION_STACK_DEPTH  (4u)  //!< Maximal nesting of loops and subroutine calls
+#define TIME_SCALE_SHIFT    (6u)     //!< Fraction bits of the time scales
+#define TIME_SCALE_UNITY    ( 1u << TIME_SCALE_SHIFT )  //!< Time scale of the instructions as stored
+#define TIME_SCALE_MAX      ( 16u * TIME_SCALE_UNITY )  //!< Longest time scale of nested calls, the scaled timings stay in 32 bits
+#define STATE_NONE          (0xFFFFu)  //!< No instruction has been executed yet
+#define LAYER_FREE          (0xFFu)    //!< The layer runs no subroutine
+#define LAYER_ALL_LEDS      (0xFFFFu)  //!< LED mask of a layer covering the whole output
+#define FADE_RATE_SHIFT     (16u)      //!< Fraction bits of the fade rate, precise for fades of many thousand timer ticks too
+#define FADE_RECIPROCAL_MIN (128u)     //!< Shortest normalized fade length in gau16FadeReciprocals[]
+#define FADE_RECIPROCAL_MAX (255u)     //!< Longest normalized fade length in gau16FadeReciprocals[]
+#define FADE_RECIPROCAL_SHIFT  (2u)    //!< Fade rate bits dropped from gau16FadeReciprocals[] to fit in 16 bits
+#ifdef ANIMATION_TICK_TIMEBASE
+#define TIMING_IN_TICKS     (0x8000u)  //!< Timing flag: the timing is given in timer ticks, see TICKS()
+#define VM_TIME( u16Ms )    ( (U32)(u16Ms) * TIMER_TICKS_PER_MS )  //!< Time unit of the virtual machine: timer ticks
+#define VM_TIMER()          Util_GetTimerTicks()
+#define VM_TIMER_ISR()      gu16TimerTicks  //!< The timer read from an interrupt routine
+#else
+#define VM_TIME( u16Ms )    (u16Ms)    //!< Time unit of the virtual machine: ms
+#define VM_TIMER()          Util_GetTimerMs()
+#define VM_TIMER_ISR()      gu16TimerMS
+#endif
+#ifdef ANIMATION_IN_PENDSV
+#define WAKEUP_NEVER        (0xFFFFFFFFu)  //!< The track has no more instructions
+#define WAKEUP_MAX          (0x7FFFu)      //!< Longest sleep of the animations between two cycles, the wakeup time is compared as signed
+#endif
+#ifdef ANIMATION_CROSSFADE_MS
+//! FADE_PROGRESS_MAX / crossfade length with FADE_RATE_SHIFT fraction bits, rounded up so that the last step is the full weight
+#define CROSSFADE_RATE      ( ( ( (U32)FADE_PROGRESS_MAX << FADE_RATE_SHIFT ) + VM_TIME( ANIMATION_CROSSFADE_MS ) - 1u ) / VM_TIME( ANIMATION_CROSSFADE_MS ) )
+#endif
+
+// Instruction packing, see the description on the top
+#define MAGNITUDE( i8Value )         ( (U8)( ( (i8Value) < 0 ) ? -(i8Value) : (i8Value) ) & 0x0Fu )
+#define NIBBLES( i8Low, i8High )     (U8)( MAGNITUDE( i8Low ) | ( MAGNITUDE( i8High ) << 4u ) )
+#define SIGN( i8Value, u8Bit )       ( ( (i8Value) < 0 ) ? ( 1u << (u8Bit) ) : 0u )
+#define U16_BYTES( u16Value )        (U8)( (u16Value) & 0xFFu ), (U8)( (u16Value) >> 8u )  //!< Little endian
+#define TIMING( u16Ms )              U16_BYTES( u16Ms )
+#define LED_MAGNITUDES( a, b, c, d, e, f, g, h, i, j, k, l )  NIBBLES( a, b ), NIBBLES( c, d ), NIBBLES( e, f ), \
+                                                             NIBBLES( g, h ), NIBBLES( i, j ), NIBBLES( k, l )
+#define LED_SIGNS( a, b, c, d, e, f, g, h, i, j, k, l )  (U8)( SIGN( a, 0u ) | SIGN( b, 1u ) | SIGN( c, 2u ) | SIGN( d, 3u ) | \
+                                                             SIGN( e, 4u ) | SIGN( f, 5u ) | SIGN( g, 6u ) | SIGN( h, 7u ) ), \
+                                                        (U8)( SIGN( i, 0u ) | SIGN( j, 1u ) | SIGN( k, 2u ) | SIGN( l, 3u ) )
+#define RGB_MAGNITUDES( r, g, b )    NIBBLES( r, g ), NIBBLES( b, 0 )
+#define RGB_SIGNS( r, g, b )         (U8)( SIGN( r, 0u ) | SIGN( g, 1u ) | SIGN( b, 2u ) )
+#ifdef ANIMATION_TICK_TIMEBASE
+//! Timing in 100 usec timer ticks [1; 32767], instead of ms
+#define TICKS( u16Ticks )            ( TIMING_IN_TICKS | (u16Ticks) )
+#else
+//! Timing in 100 usec timer ticks, rounded up to ms as the machine runs on the ms timer
+#define TICKS( u16Ticks )            ( ( (u16Ticks) + TIMER_TICKS_PER_MS - 1u ) / TIMER_TICKS_PER_MS )
+#endif
+//! Load instruction for the normal LEDs, the values are given in parentheses
+#define LOAD_LEDS( u16Ms, Values )                       LOAD, TIMING( u16Ms ), LED_MAGNITUDES Values
+//! Any other instruction for the normal LEDs, the values are given in parentheses
+#define EXEC_LEDS( u16Ms, Values, u8Opcode, u8Operand )  (U8)( (u8Opcode) | OPCODE_EXTENDED ), TIMING( u16Ms ), LED_SIGNS Values, LED_MAGNITUDES Values, (U8)(u8Operand)
+//! Load instruction for the RGB LED, the values are given in parentheses
+#define LOAD_RGB( u16Ms, Values )                        LOAD, TIMING( u16Ms ), RGB_MAGNITUDES Values
+//! Any other instruction for the RGB LED, the values are given in parentheses
+#define EXEC_RGB( u16Ms, Values, u8Opcode, u8Operand )   (U8)( (u8Opcode) | OPCODE_EXTENDED ), TIMING( u16Ms ), RGB_SIGNS Values, RGB_MAGNITUDES Values, (U8)(u8Operand)
+//! One changed value of a delta load
+#define PATCH( u8Index, i8Value )    (U8)( ( (u8Index) << 4u ) | MAGNITUDE( i8Value ) )
+#define NUM_PATCHES( ... )           NUM_PATCHES_( __VA_ARGS__, 12u, 11u, 10u, 9u, 8u, 7u, 6u, 5u, 4u, 3u, 2u, 1u, 0u )
+#define NUM_PATCHES_( p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11, p12, u8Num, ... )  (U8)(u8Num)
+//! Load instruction for the normal LEDs, given by the PATCH()es to the values of the previous instruction
+#define DELTA_LEDS( u16Ms, ... )     OPCODE_DELTA, TIMING( u16Ms ), NUM_PATCHES( __VA_ARGS__ ), __VA_ARGS__
+//! Start of a loop, the instructions up to END_LOOP() are decoded (u8Count) times
+#define LOOP( u8Count )              OPCODE_LOOP, (U8)(u8Count)
+//! End of a loop
+#define END_LOOP()                   OPCODE_END_LOOP
+//! Subroutine call (E_ANIMATION_SUBROUTINE)
+#define CALL( eSubroutine )          OPCODE_CALL, (U8)(eSubroutine), (U8)TIME_SCALE_UNITY
+//! Subroutine call with the timings of the subroutine scaled to (u16Percent) %, at most 398 % (255 / TIME_SCALE_UNITY)
+#define CALL_SCALED( eSubroutine, u16Percent )  OPCODE_CALL, (U8)(eSubroutine), (U8)( ( ( (u16Percent) * TIME_SCALE_UNITY ) + 50u ) / 100u )
+//! Continues the track with a subroutine, never returns
+#define JUMP( eSubroutine )          OPCODE_JUMP, (U8)(eSubroutine)
+//! Runs a subroutine as a layer over the track (E_ANIMATION_BLEND)
+#define LAYER( eSubroutine, eBlend ) OPCODE_LAYER, (U8)(eSubroutine), (U8)(eBlend), U16_BYTES( LAYER_ALL_LEDS )
+//! Runs a subroutine as an independent track of the LEDs in the mask
+#define TRACK( eSubroutine, u16Mask )  OPCODE_LAYER, (U8)(eSubroutine), (U8)BLEND_REPLACE, U16_BYTES( u16Mask )
+//! Bit of an LED (or of a color of the RGB LED) in the mask of a TRACK()
+#define LED_BIT( u8Index )           ( 1u << (u8Index) )
+//! Generator instruction for the normal LEDs (E_ANIMATION_GENERATOR), executed (u8Repeat + 1) times
+#define GENERATE_LEDS( u16Ms, eGenerator, Values, u8Parameter, u8Repeat )  (U8)( OPCODE_GENERATE | ( (eGenerator) << 4u ) ), TIMING( u16Ms ), \
+                                                                          LED_MAGNITUDES Values, (U8)(u8Parameter), (U8)(u8Repeat)
+//! Generator instruction for the RGB LED (E_ANIMATION_GENERATOR), executed (u8Repeat + 1) times
+#define GENERATE_RGB( u16Ms, eGenerator, Values, u8Parameter, u8Repeat )   (U8)( OPCODE_GENERATE | ( (eGenerator) << 4u ) ), TIMING( u16Ms ), \
+                                                                          RGB_MAGNITUDES Values, (U8)(u8Parameter), (U8)(u8Repeat)
+//! Fade of the normal LEDs to the values in (u16Ms) ms, along an easing curve (E_ANIMATION_EASING)
+#define FADE_LEDS( u16Ms, Values, eEasing )  GENERATE_LEDS( u16Ms, GENERATOR_FADE, Values, eEasing, 0u )
+//! Fade of the RGB LED to the values in (u16Ms) ms, along an easing curve (E_ANIMATION_EASING)
+#define FADE_RGB( u16Ms, Values, eEasing )   GENERATE_RGB( u16Ms, GENERATOR_FADE, Values, eEasing, 0u )
 
 
 /***************************************< Types >**************************************/
@@ -47,1106 +198,1191 @@ typedef enum
   LSHIFT    = 0x04u,  //!< Shifts all the current LED brightness levels anticlockwise
 //  UMOVE     = 0x04u,  //!< Moves some of the values upwards. Uses saturation logic. Doesn't roll over.
 //  DMOVE     = 0x08u,  //!< Moves some of the values downwards. Uses saturation logic. Doesn't roll over.
+  GENERATE  = 0x08u,  //!< Computes the brightness levels with a generator. Decoded instructions only, it's OPCODE_EXTENDED in the flash.
   DIV       = 0x10u,  //!< Divides the the current LED brightness levels by the given number
   USOURCE   = 0x20u,  //!< Add values to the brightness and if it overflows/underflows then it will be added to the upwards next value. If it overflows/underflows then it will do the same until it reaches the uppper or lower end.
   DSOURCE   = 0x40u,  //!< Add values to the brightness and if it overflows/underflows then it will be added to the downwards next value. If it overflows/underflows then it will do the same until it reaches the uppper or lower end.
   REPEAT    = 0x80u   //!< Do the instruction and repeat by (operand)-times
 } E_ANIMATION_OPCODE;
 
-//! \brief Instruction used by the animation state machine -- for normal LEDs
+//! \brief Generators of the GENERATE instructions
+typedef enum
+{
+  GENERATOR_NOISE = 0u,  //!< Random levels, up to the values
+  GENERATOR_FLICKER,     //!< The values, each darkened by a random amount up to the parameter
+  GENERATOR_SPARKLE,     //!< The values, with a random one of them set to the parameter
+  GENERATOR_SINE,        //!< Sine wave, the values are the phase offsets in 1/16 periods, the parameter is the phase step in 1/256 periods
+  GENERATOR_TRIANGLE,    //!< Triangle wave, the same way as the sine
+  GENERATOR_FADE         //!< Fade from the previous levels to the values, the parameter is the easing (E_ANIMATION_EASING)
+} E_ANIMATION_GENERATOR;
+
+//! \brief Easing curves of the fades
+typedef enum
+{
+  EASE_LINEAR = 0u,      //!< Constant speed
+  EASE_IN,               //!< Speeding up (quadratic)
+  EASE_OUT,              //!< Slowing down (quadratic)
+  EASE_IN_OUT            //!< Speeding up, then slowing down (smoothstep)
+} E_ANIMATION_EASING;
+
+//! \brief Blend modes of the layers, in the full brightness range
+typedef enum
+{
+  BLEND_MAX = 0u,        //!< The brighter one of the track and the layer
+  BLEND_ADD,             //!< Sum of the track and the layer, saturated
+  BLEND_MULTIPLY,        //!< The track dimmed by the layer
+  BLEND_REPLACE          //!< The layer only, see TRACK()
+} E_ANIMATION_BLEND;
+
+//! \brief Instruction used by the animation state machine, decoded
 typedef struct
 {
-  U16 u16TimingMs;                               //!< How long the machine should stay in this state
-  I8  ai8LEDBrightness[ LEDS_NUM ];              //!< Brightness of each LED
+  U32 u32Timing;                                 //!< How long the machine should stay in this state (VM_TIME() units)
+  I8  ai8Values[ LEDS_NUM ];                     //!< Brightness of each LED (or of each color of the RGB LED)
   U8  u8AnimationOpcode;                         //!< Opcode (E_ANIMATION_OPCODE)
   U8  u8AnimationOperand;                        //!< Opcode-specific operand
-} S_ANIMATION_INSTRUCTION_NORMAL;
+  U8  u8Generator;                               //!< Generator of a GENERATE instruction (E_ANIMATION_GENERATOR)
+  U8  u8GeneratorParameter;                      //!< Generator-specific parameter
+} S_ANIMATION_INSTRUCTION;
 
-//! \brief Instruction used by the animation state machine -- for the RGB LED
+//! \brief Shared instruction sequences, called from the animations
+typedef enum
+{
+  SUBROUTINE_SHOOTING_STAR = 0u,             //!< gau8ShootingStar[]
+  SUBROUTINE_SHOOTING_STAR_RGB,              //!< gau8ShootingStarRGB[]
+  SUBROUTINE_SHOOTING_STAR_HOPEHELY,         //!< gau8ShootingStar_hopehely[]
+  SUBROUTINE_BUTTONS_MEZI,                   //!< gau8Buttons_mezi[]
+  NUM_SUBROUTINES
+} E_ANIMATION_SUBROUTINE;
+
+//! \brief Subroutine structure
 typedef struct
 {
-  U16 u16TimingMs;                               //!< How long the machine should stay in this state
-  I8  ai8RGBLEDBrightness[ NUM_RGBLED_COLORS ];  //!< Brightness of each color
-  U8  u8AnimationOpcode;                         //!< Opcode (E_ANIMATION_OPCODE)
-  U8  u8AnimationOperand;                        //!< Opcode-specific operand
-} S_ANIMATION_INSTRUCTION_RGB;
+  U16            u16CodeSize;  //!< Size of the packed instructions in bytes
+  const U8 CODE* pu8Code;      //!< Pointer to the packed instructions
+} S_ANIMATION_SUBROUTINE;
+
+//! \brief Loop or subroutine call being decoded
+typedef struct
+{
+  const U8 CODE* pu8Continue;  //!< First instruction of the loop body, or the instruction after the call
+  const U8 CODE* pu8BlockEnd;  //!< End of the code block containing the loop or the call
+  U8             u8Count;      //!< Remaining passes of the loop, 0 for a call
+  U16            u16TimeScale; //!< Time scale of the caller (TIME_SCALE_UNITY: as stored)
+} S_ANIMATION_FRAME;
+
+//! \brief Streaming decoder of an instruction track (normal LEDs or RGB LED)
+typedef struct
+{
+  const U8 CODE*          pu8Code;             //!< First packed instruction
+  const U8 CODE*          pu8CodeEnd;          //!< End of the packed instructions
+  const U8 CODE*          pu8Next;             //!< Next packed instruction to be decoded, never a control flow one
+  const U8 CODE*          pu8BlockEnd;         //!< End of the code block of pu8Next (the track or a subroutine)
+  S_ANIMATION_FRAME       asStack[ ANIMATION_STACK_DEPTH ];  //!< Loops and calls being decoded
+  S_ANIMATION_INSTRUCTION asWindow[ 2u ];      //!< The last two decoded instructions, a repeat may step back by one
+  U32                     au32Deadline[ 2u ];  //!< Timer value at the end of the instructions in asWindow[]
+  U32                     u32WindowStart;      //!< Timer value at the start of the older instruction in asWindow[]
+  U16                     u16Decoded;          //!< Number of instructions decoded since the start of the track
+  U8                      u8Newest;            //!< Index of the newest instruction in asWindow[]
+  U8                      u8NumValues;         //!< Number of brightness values in an instruction
+  U8                      u8Depth;             //!< Number of frames in asStack[]
+  U16                     u16TimeScale;        //!< Time scale of the decoded instructions (TIME_SCALE_UNITY: as stored)
+} S_ANIMATION_TRACK;
+
+//! \brief State of the virtual machine for one output (normal LEDs or RGB LED)
+typedef struct
+{
+  U8*  pu8Levels;                                //!< Brightness levels [0; ANIMATION_LEVEL_MAX]
+  U32* pu32Timer;                                //!< Animation timer
+  U8   u8NumValues;                              //!< Number of brightness levels
+  U8   u8RightStart;                             //!< Index of the first level on the right side, the sources flow on the two sides separately
+  U16  u16LastState;                             //!< Previously executed instruction index
+  U8   u8RepetitionCounter;                      //!< Instruction repetition counter
+  U8   u8Phase;                                  //!< Phase of the wave generators in 1/256 periods
+  U16  u16Random;                                //!< State of the random generator (LFSR), never zero
+  U8   au8FadeFrom[ LEDS_NUM ];                  //!< Levels at the start of the running fade
+  U32  u32FadeStart;                             //!< Timer value at the start of the running fade
+  U32  u32FadeDuration;                          //!< Length of the running fade (VM_TIME() units), 0 if there's none
+  U32  u32FadeRate;                              //!< FADE_PROGRESS_MAX / u32FadeDuration, FADE_RATE_SHIFT fraction bits, see FadeRate()
+  U16  u16FadeProgress;                          //!< Eased progress of the running fade [0; FADE_PROGRESS_MAX)
+  U8   u8FadeEasing;                             //!< Easing curve of the running fade (E_ANIMATION_EASING)
+} S_ANIMATION_CHANNEL;
+
+//! \brief Program running over the animation, see LAYER()
+typedef struct
+{
+  S_ANIMATION_TRACK   sTrack;                    //!< Instruction decoder of the layer
+  S_ANIMATION_CHANNEL sChannel;                  //!< Virtual machine of the layer
+  U8                  au8Levels[ LEDS_NUM ];     //!< Brightness levels of the layer [0; ANIMATION_LEVEL_MAX]
+  U32                 u32Timer;                  //!< Animation timer of the layer, it restarts on its own
+  U8                  u8Subroutine;              //!< The subroutine running on the layer (E_ANIMATION_SUBROUTINE), LAYER_FREE if none
+  U8                  u8Blend;                   //!< Blend mode (E_ANIMATION_BLEND)
+  U16                 u16Mask;                   //!< The LEDs covered by the layer, bit 0 is the first one
+} S_ANIMATION_LAYER;
 
 //! \brief Animation structure
 typedef struct
 {
-  U8                                         u8AnimationLengthNormal;  //!< How many instructions this animation has for the normal LEDs
-  const S_ANIMATION_INSTRUCTION_NORMAL CODE* psInstructionsNormal;     //!< Pointer to the instructions themselves -- normal LEDs
-  U8                                         u8AnimationLengthRGB;     //!< How many instructions this animation has for the RGB LED
-  const S_ANIMATION_INSTRUCTION_RGB CODE*    psInstructionsRGB;        //!< Pointer to the instructions themselves -- RGB LED
+  U16            u16CodeSizeNormal;  //!< Size of the packed instructions for the normal LEDs in bytes
+  const U8 CODE* pu8CodeNormal;      //!< Pointer to the packed instructions -- normal LEDs
+  U16            u16CodeSizeRGB;     //!< Size of the packed instructions for the RGB LED in bytes
+  const U8 CODE* pu8CodeRGB;         //!< Pointer to the packed instructions -- RGB LED
 } S_ANIMATION;
 
 
 /***************************************< Constants >**************************************/
+//! \brief First half of a sine period in 1/32 periods, starting from the darkest level
+CODE const U8 gau8SineHalfWave[ 16u ] =
+{
+  0u, 0u, 1u, 2u, 3u, 4u, 5u, 7u, 8u, 10u, 11u, 12u, 13u, 14u, 15u, 15u
+};
+
+//! \brief Reciprocals of the divisors in 1/256 units, (level * gau8Reciprocals[ d ]) >> 8 == level / d for every level
+//! \note  Entries 0 and 1 are not used: dividing by 0 is skipped and dividing by 1 leaves the level unchanged
+CODE const U8 gau8Reciprocals[ ANIMATION_LEVEL_MAX + 1u ] =
+{
+  0u, 0u, 128u, 86u, 64u, 52u, 43u, 37u, 32u, 29u, 26u, 24u, 22u, 20u, 19u, 18u
+};
+
+//! \brief Fade rates of the normalized fade lengths [FADE_RECIPROCAL_MIN; FADE_RECIPROCAL_MAX], see FadeRate()
+//! \note  ( FADE_PROGRESS_MAX << FADE_RATE_SHIFT ) / length >> FADE_RECIPROCAL_SHIFT, rounded down
+CODE const U16 gau16FadeReciprocals[ FADE_RECIPROCAL_MAX - FADE_RECIPROCAL_MIN + 1u ] =
+{
+  32768u, 32513u, 32263u, 32017u, 31775u, 31536u, 31300u, 31068u, 30840u, 30615u, 30393u, 30174u,
+  29959u, 29746u, 29537u, 29330u, 29127u, 28926u, 28728u, 28532u, 28339u, 28149u, 27962u, 27776u,
+  27594u, 27413u, 27235u, 27060u, 26886u, 26715u, 26546u, 26379u, 26214u, 26051u, 25890u, 25731u,
+  25575u, 25420u, 25266u, 25115u, 24966u, 24818u, 24672u, 24528u, 24385u, 24244u, 24105u, 23967u,
+  23831u, 23696u, 23563u, 23431u, 23301u, 23172u, 23045u, 22919u, 22795u, 22671u, 22550u, 22429u,
+  22310u, 22192u, 22075u, 21959u, 21845u, 21732u, 21620u, 21509u, 21399u, 21290u, 21183u, 21076u,
+  20971u, 20867u, 20763u, 20661u, 20560u, 20460u, 20360u, 20262u, 20164u, 20068u, 19972u, 19878u,
+  19784u, 19691u, 19599u, 19508u, 19418u, 19328u, 19239u, 19152u, 19065u, 18978u, 18893u, 18808u,
+  18724u, 18641u, 18558u, 18477u, 18396u, 18315u, 18236u, 18157u, 18078u, 18001u, 17924u, 17848u,
+  17772u, 17697u, 17623u, 17549u, 17476u, 17403u, 17331u, 17260u, 17189u, 17119u, 17050u, 16980u,
+  16912u, 16844u, 16777u, 16710u, 16644u, 16578u, 16513u, 16448u
+};
+
 //! \brief Retro animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasRetroVersion[ 8u ] = 
+CODE const U8 gau8RetroVersion[] = 
 {
-  {133u, {15,  0, 15,  0,  0, 15, 15,  0, 15,  0,  0, 15}, LOAD, 0u },
-  {133u, { 0, 15,  0, 15, 15,  0,  0, 15,  0, 15, 15,  0}, LOAD, 0u },
-  {133u, {15,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD, 0u },
-  {133u, { 0, 15,  0, 15, 15,  0,  0, 15,  0, 15, 15,  0}, LOAD, 0u },
-  {133u, {15,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD, 0u },
-  {133u, { 0,  0,  0, 15,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD, 0u },
-  {133u, {15,  0, 15,  0,  0, 15, 15,  0,  0, 15,  0, 15}, LOAD, 0u },
-  {133u, { 0,  0,  0, 15,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD, 0u },
+  LOAD_LEDS( 133u, (15,  0, 15,  0,  0, 15, 15,  0, 15,  0,  0, 15) ),
+  LOOP( 2u ),
+    LOAD_LEDS( 133u, ( 0, 15,  0, 15, 15,  0,  0, 15,  0, 15, 15,  0) ),
+    LOAD_LEDS( 133u, (15,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0) ),
+  END_LOOP(),
+  DELTA_LEDS( 133u, PATCH(  0,  0 ), PATCH(  3, 15 ), PATCH(  6,  0 ), PATCH(  9, 15 ) ),
+  LOAD_LEDS( 133u, (15,  0, 15,  0,  0, 15, 15,  0,  0, 15,  0, 15) ),
+  LOAD_LEDS( 133u, ( 0,  0,  0, 15,  0,  0,  0,  0,  0, 15,  0,  0) ),
 };
 //! \brief Retro animation (red) -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasRetroVersionRGB[ 4u ] = 
+CODE const U8 gau8RetroVersionRGB[] = 
 {
-  {133u, {15,  0,  0}, LOAD, 0u },
-  {665u, { 0,  0,  0}, LOAD, 0u },
-  {133u, {15,  0,  0}, LOAD, 0u },
-  {133u, { 0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 133u, (15,  0,  0) ),
+  LOAD_RGB( 665u, ( 0,  0,  0) ),
+  LOAD_RGB( 133u, (15,  0,  0) ),
+  LOAD_RGB( 133u, ( 0,  0,  0) ),
 };
 //! \brief Retro animation (yellow) -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasRetroVersionRGB_yellow[ 4u ] = 
+CODE const U8 gau8RetroVersionRGB_yellow[] = 
 {
-  {133u, {15, 15,  0}, LOAD, 0u },
-  {665u, { 0,  0,  0}, LOAD, 0u },
-  {133u, {15, 15,  0}, LOAD, 0u },
-  {133u, { 0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 133u, (15, 15,  0) ),
+  LOAD_RGB( 665u, ( 0,  0,  0) ),
+  LOAD_RGB( 133u, (15, 15,  0) ),
+  LOAD_RGB( 133u, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief "Sine" wave flasher animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSoftFlashing[ 4u ] = 
+CODE const U8 gau8SoftFlashing[] = 
 {
-  {125u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,          0u },
-  {125u, { 1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1}, ADD | REPEAT, 14u },
-  {125u, {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD,          0u }, 
-  {125u, {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}, ADD | REPEAT, 14u },
+  GENERATE_LEDS( 125u, GENERATOR_TRIANGLE, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), 8u, 0u ),
+  GENERATE_LEDS( 125u, GENERATOR_TRIANGLE, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), 8u, 30u ),
 };
 //! \brief "Sine" wave flasher animation (red) -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSoftFlashingRGB[ 4u ] = 
+CODE const U8 gau8SoftFlashingRGB[] = 
 {
-  {125u, { 0,  0,  0}, LOAD,          0u },
-  {125u, { 1,  0,  0}, ADD | REPEAT, 14u },
-  {125u, {15,  0,  0}, LOAD,          0u }, 
-  {125u, {-1,  0,  0}, ADD | REPEAT, 14u },
+  LOAD_RGB( 125u, ( 0,  0,  0) ),
+  FADE_RGB( 1875u, (15,  0,  0), EASE_LINEAR ),
+  LOAD_RGB( 125u, (15,  0,  0) ),
+  FADE_RGB( 1875u, ( 0,  0,  0), EASE_LINEAR ),
 };
 //! \brief "Sine" wave flasher animation (blue) -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSoftFlashingRGB_hopehely[ 4u ] = 
+CODE const U8 gau8SoftFlashingRGB_hopehely[] = 
 {
-  {125u, { 0,  0,  0}, LOAD,          0u },
-  {125u, { 0,  0,  1}, ADD | REPEAT, 14u },
-  {125u, { 0,  0, 15}, LOAD,          0u }, 
-  {125u, { 0,  0, -1}, ADD | REPEAT, 14u },
+  LOAD_RGB( 125u, ( 0,  0,  0) ),
+  FADE_RGB( 1875u, ( 0,  0, 15), EASE_LINEAR ),
+  LOAD_RGB( 125u, ( 0,  0, 15) ),
+  FADE_RGB( 1875u, ( 0,  0,  0), EASE_LINEAR ),
 };
 
 //--------------------------------------------------------
 //! \brief "Fade ring" animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasFadeRing[ 3u ] =
+CODE const U8 gau8FadeRing[] =
 {
-  { 40u, {15,  1, 15,  1, 15,  1,  1, 15,  1, 15,  1, 15}, LOAD,          0u },
-  { 40u, {-1,  1, -1,  1, -1,  1,  1, -1,  1, -1,  1, -1}, ADD | REPEAT, 13u },
-  { 40u, { 1, -1,  1, -1,  1, -1, -1,  1, -1,  1, -1,  1}, ADD | REPEAT, 13u },
+  LOAD_LEDS( 40u, (15,  1, 15,  1, 15,  1,  1, 15,  1, 15,  1, 15) ),
+  FADE_LEDS( 560u, ( 1, 15,  1, 15,  1, 15, 15,  1, 15,  1, 15,  1), EASE_LINEAR ),
+  FADE_LEDS( 560u, (15,  1, 15,  1, 15,  1,  1, 15,  1, 15,  1, 15), EASE_LINEAR ),
 };
 //! \brief "Fade ring" animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasFadeRingRGB[ 3u ] =
+CODE const U8 gau8FadeRingRGB[] =
 {
-  { 40u, {15,  1,  0}, LOAD,          0u },
-  { 40u, {-1,  0,  0}, ADD | REPEAT, 13u },
-  { 40u, { 1,  0,  0}, ADD | REPEAT, 13u },
+  LOAD_RGB( 40u, (15,  1,  0) ),
+  FADE_RGB( 560u, ( 1,  1,  0), EASE_LINEAR ),
+  FADE_RGB( 560u, (15,  1,  0), EASE_LINEAR ),
 };
 //! \brief "Fade ring" animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasFadeRingRGB_hopehely[ 3u ] =
+CODE const U8 gau8FadeRingRGB_hopehely[] =
 {
-  { 40u, {15,  1, 15}, LOAD,          0u },
-  { 40u, {-1,  0, -1}, ADD | REPEAT, 13u },
-  { 40u, { 1,  0,  1}, ADD | REPEAT, 13u },
+  LOAD_RGB( 40u, (15,  1, 15) ),
+  FADE_RGB( 560u, ( 1,  1,  1), EASE_LINEAR ),
+  FADE_RGB( 560u, (15,  1, 15), EASE_LINEAR ),
 };
 //! \brief "Fade ring" animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasFadeRingRGB_rudolf[ 3u ] =
+CODE const U8 gau8FadeRingRGB_rudolf[] =
 {
-  { 40u, {0,   0,  0}, LOAD,          0u },
-  { 40u, {1,   0,  0}, ADD | REPEAT,  13u },
-  { 40u, {-1,  0,  0}, ADD | REPEAT,  13u }
+  LOAD_RGB( 40u, (0,   0,  0) ),
+  FADE_RGB( 560u, (14,  0,  0), EASE_LINEAR ),
+  FADE_RGB( 560u, ( 0,  0,  0), EASE_LINEAR )
 };
 
 //--------------------------------------------------------
 //! \brief Shooting star anticlockwise animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasShootingStar[ 7u ] = 
+CODE const U8 gau8ShootingStar[] = 
 { 
-  {100u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 2u },
-  {100u, { 0,  0,  0,  0,  5, 10,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  5, 15,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0, 10, 15,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  5, 10, 15,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 4u },
+  DELTA_LEDS( 100u, PATCH(  0,  5 ), PATCH(  1, 10 ), PATCH(  2, 15 ) ),
+  EXEC_LEDS( 100u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), RSHIFT | REPEAT, 2u ),
+  DELTA_LEDS( 100u, PATCH(  4,  5 ), PATCH(  5, 10 ) ),
+  DELTA_LEDS( 100u, PATCH(  4,  0 ), PATCH(  5,  5 ), PATCH(  6, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  5,  0 ), PATCH(  6, 10 ), PATCH(  7, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  6,  5 ), PATCH(  7, 10 ), PATCH(  8, 15 ) ),
+  EXEC_LEDS( 100u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), RSHIFT | REPEAT, 4u ),
 };
 //! \brief Shooting star anticlockwise animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasShootingStarRGB[ 4u ] = 
+CODE const U8 gau8ShootingStarRGB[] = 
 { 
-  {400u, { 0,  0,  0}, LOAD,            0u },
-  {100u, {15,  0,  0}, LOAD,            0u },
-  {100u, {-5,  0,  0}, ADD | REPEAT,    1u },
-  {600u, { 0,  0,  0}, LOAD,            0u },
+  LOAD_RGB( 400u, ( 0,  0,  0) ),
+  LOAD_RGB( 100u, (15,  0,  0) ),
+  EXEC_RGB( 100u, (-5,  0,  0), ADD | REPEAT, 1u ),
+  LOAD_RGB( 600u, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Star launch animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasStarLaunch[ 5u ] = 
+CODE const U8 gau8StarLaunch[] = 
 {
-  {400u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,              0u },
-  {200u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,              0u },
-  {200u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, USOURCE | REPEAT, 18u },
-  {200u, {15, 15, 15, 15, 15, 15, 10, 15, 15, 15, 15, 15}, LOAD,              0u },
-  {200u, { 0,  0,  0,  0,  0, -5, -5,  0,  0,  0,  0,  0}, DSOURCE | REPEAT, 16u },
+  DELTA_LEDS( 400u, PATCH(  0,  0 ) ),
+  DELTA_LEDS( 200u, PATCH(  0,  5 ) ),
+  EXEC_LEDS( 200u, ( 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5), USOURCE | REPEAT, 18u ),
+  LOAD_LEDS( 200u, (15, 15, 15, 15, 15, 15, 10, 15, 15, 15, 15, 15) ),
+  EXEC_LEDS( 200u, ( 0,  0,  0,  0,  0, -5, -5,  0,  0,  0,  0,  0), DSOURCE | REPEAT, 16u ),
 };
 //! \brief Star launch animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasStarLaunchRGB[ 5u ] = 
+CODE const U8 gau8StarLaunchRGB[] = 
 {
-  {4000u, { 0,  0,  0}, LOAD,         0u},
-  { 800u, {15, 15,  0}, LOAD,         0u},
-  { 200u, { 0, -1,  0}, ADD | REPEAT, 9u},
-  { 200u, {-3, -1,  0}, ADD | REPEAT, 4u},
-  { 200u, { 0,  0,  0}, LOAD,         0u},
+  LOAD_RGB( 4000u, ( 0,  0,  0) ),
+  LOAD_RGB( 800u, (15, 15,  0) ),
+  FADE_RGB( 2000u, (15,  5,  0), EASE_LINEAR ),
+  EXEC_RGB( 200u, (-3, -1,  0), ADD | REPEAT, 4u ),
+  LOAD_RGB( 200u, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Star launch animation for "Rudolf" -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasStarLaunch_rudolf[ 9u ] = 
+CODE const U8 gau8StarLaunch_rudolf[] = 
 {
-  {400u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,              0u },
-  {200u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,              0u },
-  {200u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, USOURCE | REPEAT,  7u },
-  {200u, {15, 15, 15,  0,  0,  5,  0,  0,  0, 15, 15, 15}, LOAD,              0u },
-  {200u, { 0,  0,  0,  0,  0,  5,  5,  0,  0,  0,  0,  0}, DSOURCE | REPEAT, 10u },
-  {200u, {15, 15, 15, 15, 15, 15, 15, 15, 10, 15, 15, 15}, LOAD,              0u },
-  {200u, { 0,  0,  0, -5,  0,  0,  0,  0, -5,  0,  0,  0}, USOURCE | REPEAT,  7u },
-  {200u, {15, 15, 15,  0,  0,  0,  0,  0,  0, 10, 15, 15}, LOAD,              0u },
-  {200u, { 0,  0, -5,  0,  0,  0,  0,  0,  0, -5,  0,  0}, DSOURCE | REPEAT,  8u }
+  DELTA_LEDS( 400u, PATCH(  0,  0 ) ),
+  DELTA_LEDS( 200u, PATCH(  0,  5 ) ),
+  EXEC_LEDS( 200u, ( 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5), USOURCE | REPEAT, 7u ),
+  LOAD_LEDS( 200u, (15, 15, 15,  0,  0,  5,  0,  0,  0, 15, 15, 15) ),
+  EXEC_LEDS( 200u, ( 0,  0,  0,  0,  0,  5,  5,  0,  0,  0,  0,  0), DSOURCE | REPEAT, 10u ),
+  LOAD_LEDS( 200u, (15, 15, 15, 15, 15, 15, 15, 15, 10, 15, 15, 15) ),
+  EXEC_LEDS( 200u, ( 0,  0,  0, -5,  0,  0,  0,  0, -5,  0,  0,  0), USOURCE | REPEAT, 7u ),
+  LOAD_LEDS( 200u, (15, 15, 15,  0,  0,  0,  0,  0,  0, 10, 15, 15) ),
+  EXEC_LEDS( 200u, ( 0,  0, -5,  0,  0,  0,  0,  0,  0, -5,  0,  0), DSOURCE | REPEAT, 8u )
 };
 
 //--------------------------------------------------------
 //! \brief Generic flasher animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasGenericFlasher[ 2u ] = 
+CODE const U8 gau8GenericFlasher[] = 
 {
-  {500u, {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD, 0u }, 
-  {500u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD, 0u },
+  LOAD_LEDS( 500u, (15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15) ),
+  LOAD_LEDS( 500u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0) ),
 };
 //! \brief Generic flasher animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasGenericFlasherRGB[ 2u ] = 
+CODE const U8 gau8GenericFlasherRGB[] = 
 {
-  {500u, { 7,  7,  7}, LOAD, 0u }, 
-  {500u, { 0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 500u, ( 7,  7,  7) ),
+  LOAD_RGB( 500u, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief KITT animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasKITT[ 22u ] = 
-{
-  {200u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, LOAD,  0u },
-  {100u, {10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10}, LOAD,  0u },
-  {100u, {15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15}, LOAD,  0u },
-  {100u, {10, 15, 10,  5,  0,  0,  0,  0,  5, 10, 15, 10}, LOAD,  0u },
-  {100u, { 5, 10, 15, 10,  5,  0,  0,  5, 10, 15, 10,  5}, LOAD,  0u },
-  {100u, { 0,  5, 10, 15, 10,  5,  5, 10, 15, 10,  5,  0}, LOAD,  0u },
-  {100u, { 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  5, 10, 15, 15, 10,  5,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  0,  5, 10, 10,  5,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  0,  0,  5,  5,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  0,  0,  5,  5,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  0,  5, 10, 10,  5,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  5, 10, 15, 15, 10,  5,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0}, LOAD,  0u },
-  {100u, { 0,  5, 10, 15, 10,  5,  5, 10, 15, 10,  5,  0}, LOAD,  0u },
-  {100u, { 5, 10, 15, 10,  5,  0,  0,  5, 10, 15, 10,  5}, LOAD,  0u },
-  {100u, {10, 15, 10,  5,  0,  0,  0,  0,  5, 10, 15, 10}, LOAD,  0u },
-  {100u, {15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15}, LOAD,  0u },
-  {100u, {10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10}, LOAD,  0u },
-  {100u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, LOAD,  0u },
+CODE const U8 gau8KITT[] = 
+{
+  DELTA_LEDS( 200u, PATCH(  0,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  0,  5 ), PATCH( 11,  5 ) ),
+  DELTA_LEDS( 100u, PATCH(  0, 10 ), PATCH(  1,  5 ), PATCH( 10,  5 ), PATCH( 11, 10 ) ),
+  LOAD_LEDS( 100u, (15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15) ),
+  LOAD_LEDS( 100u, (10, 15, 10,  5,  0,  0,  0,  0,  5, 10, 15, 10) ),
+  LOAD_LEDS( 100u, ( 5, 10, 15, 10,  5,  0,  0,  5, 10, 15, 10,  5) ),
+  LOAD_LEDS( 100u, ( 0,  5, 10, 15, 10,  5,  5, 10, 15, 10,  5,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  0,  5, 10, 15, 15, 10,  5,  0,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  0,  0,  5, 10, 10,  5,  0,  0,  0,  0) ),
+  DELTA_LEDS( 100u, PATCH(  4,  0 ), PATCH(  5,  5 ), PATCH(  6,  5 ), PATCH(  7,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  5,  0 ), PATCH(  6,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  5,  5 ), PATCH(  6,  5 ) ),
+  DELTA_LEDS( 100u, PATCH(  4,  5 ), PATCH(  5, 10 ), PATCH(  6, 10 ), PATCH(  7,  5 ) ),
+  LOAD_LEDS( 100u, ( 0,  0,  0,  5, 10, 15, 15, 10,  5,  0,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  5, 10, 15, 10,  5,  5, 10, 15, 10,  5,  0) ),
+  LOAD_LEDS( 100u, ( 5, 10, 15, 10,  5,  0,  0,  5, 10, 15, 10,  5) ),
+  LOAD_LEDS( 100u, (10, 15, 10,  5,  0,  0,  0,  0,  5, 10, 15, 10) ),
+  LOAD_LEDS( 100u, (15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15) ),
+  LOAD_LEDS( 100u, (10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10) ),
+  DELTA_LEDS( 100u, PATCH(  0,  5 ), PATCH(  1,  0 ), PATCH( 10,  0 ), PATCH( 11,  5 ) ),
 };
 //! \brief KITT animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasKITTRGB[ 4u ] = 
+CODE const U8 gau8KITTRGB[] = 
 {
-  { 800u, { 0,  0,  0}, LOAD,         0u },
-  { 100u, { 5,  0,  0}, ADD | REPEAT, 3u },
-  { 100u, {-5,  0,  0}, ADD | REPEAT, 3u },
-  {1300u, { 0,  0,  0}, LOAD,         0u },
+  LOAD_RGB( 800u, ( 0,  0,  0) ),
+  EXEC_RGB( 100u, ( 5,  0,  0), ADD | REPEAT, 3u ),
+  EXEC_RGB( 100u, (-5,  0,  0), ADD | REPEAT, 3u ),
+  LOAD_RGB( 1300u, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Disco animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasDisco[ 6u ] = 
+CODE const U8 gau8Disco[] = 
 {
-  {40u, {  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15}, LOAD,         0u },
-  {40u, {  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2}, DIV | REPEAT, 3u },
-  {100u,{  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,         0u },
-  {40u, { 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0}, LOAD,         0u },
-  {40u, {  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1}, DIV | REPEAT, 3u },
-  {100u,{  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,         0u },
+  LOAD_LEDS( 40u, (  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15) ),
+  EXEC_LEDS( 40u, (  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2), DIV | REPEAT, 3u ),
+  LOAD_LEDS( 100u,(  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0) ),
+  LOAD_LEDS( 40u, ( 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0) ),
+  EXEC_LEDS( 40u, (  2,  1,  2,  1,  2,  1,  2,  1,  2,  1,  2,  1), DIV | REPEAT, 3u ),
+  LOAD_LEDS( 100u,(  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0) ),
 };
 //! \brief Disco animation -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasDiscoRGB[ 6u ] = 
+CODE const U8 gau8DiscoRGB[] = 
 {
-  { 40u, {15,  0, 15}, LOAD,         0u },
-  { 40u, { 2,  1,  2}, DIV | REPEAT, 3u },
-  {100u, { 0,  0,  0}, LOAD,         0u },
-  { 40u, { 0, 15,  0}, LOAD,         0u },
-  { 40u, { 2,  1,  2}, DIV | REPEAT, 3u },
-  {100u, { 0,  0,  0}, LOAD,         0u },
+  LOAD_RGB( 40u, (15,  0, 15) ),
+  EXEC_RGB( 40u, ( 2,  1,  2), DIV | REPEAT, 3u ),
+  LOAD_RGB( 100u, ( 0,  0,  0) ),
+  LOAD_RGB( 40u, ( 0, 15,  0) ),
+  EXEC_RGB( 40u, ( 2,  1,  2), DIV | REPEAT, 3u ),
+  LOAD_RGB( 100u, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Disco animation for "Rudolf"-- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasDisco_rudolf[ 6u ] = 
+CODE const U8 gau8Disco_rudolf[] = 
 {
-  {40u, {  0, 15,  0, 15, 15, 15, 15, 15, 15, 15,  0, 15}, LOAD,         0u },
-  {40u, {  1,  2,  1,  1,  2,  1,  2,  1,  2,  2,  1,  2}, DIV | REPEAT, 3u },
-  {100u,{  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,         0u },
-  {40u, { 15,  0, 15, 15, 15, 15, 15, 15, 15,  0, 15,  0}, LOAD,         0u },
-  {40u, {  2,  1,  2,  2,  1,  2,  1,  2,  1,  1,  2,  1}, DIV | REPEAT, 3u },
-  {100u,{  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,         0u }
+  LOAD_LEDS( 40u, (  0, 15,  0, 15, 15, 15, 15, 15, 15, 15,  0, 15) ),
+  EXEC_LEDS( 40u, (  1,  2,  1,  1,  2,  1,  2,  1,  2,  2,  1,  2), DIV | REPEAT, 3u ),
+  LOAD_LEDS( 100u,(  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0) ),
+  LOAD_LEDS( 40u, ( 15,  0, 15, 15, 15, 15, 15, 15, 15,  0, 15,  0) ),
+  EXEC_LEDS( 40u, (  2,  1,  2,  2,  1,  2,  1,  2,  1,  1,  2,  1), DIV | REPEAT, 3u ),
+  LOAD_LEDS( 100u,(  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0) )
 };
 //! \brief Disco animation for "Rudolf" -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasDiscoRGB_rudolf[ 6u ] = 
+CODE const U8 gau8DiscoRGB_rudolf[] = 
 {
-  { 40u, { 0,  0, 15}, LOAD,         0u },
-  { 40u, { 2,  1,  2}, DIV | REPEAT, 3u },
-  {100u, { 0,  0,  0}, LOAD,         0u },
-  { 40u, { 0, 15,  0}, LOAD,         0u },
-  { 40u, { 2,  2,  1}, DIV | REPEAT, 3u },
-  {100u, { 0,  0,  0}, LOAD,         0u }
+  LOAD_RGB( 40u, ( 0,  0, 15) ),
+  EXEC_RGB( 40u, ( 2,  1,  2), DIV | REPEAT, 3u ),
+  LOAD_RGB( 100u, ( 0,  0,  0) ),
+  LOAD_RGB( 40u, ( 0, 15,  0) ),
+  EXEC_RGB( 40u, ( 2,  2,  1), DIV | REPEAT, 3u ),
+  LOAD_RGB( 100u, ( 0,  0,  0) )
 };
 
 //--------------------------------------------------------
 //! \brief Pseudo-random fade animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasPseudoRandomFade[ 15u ] = 
-{
-  { 66u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  { 66u, { 0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0,  1,  0,  0,  0,  0, -1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0, -1,  0,  0,  0,  0,  0,  0,  0,  1,  0}, ADD | REPEAT, 14u },
-  { 66u, { 1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1,  0}, ADD | REPEAT, 14u },
-  { 66u, {-1,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0,  0,  0,  0, -1,  0,  1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0,  0,  0,  0,  0,  0, -1,  0,  0,  0,  1}, ADD | REPEAT, 14u },
-  { 66u, { 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1}, ADD | REPEAT, 14u },
-  { 66u, { 0, -1,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0,  0, -1,  0,  0,  1,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0,  0,  0,  0,  0, -1,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },  //RGB lights up here
-  { 66u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0,  0,  0,  1,  0,  0,  0,  0, -1,  0,  0}, ADD | REPEAT, 14u },
-  { 66u, { 0,  0,  0,  0, -1,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
+CODE const U8 gau8PseudoRandomFade[] = 
+{
+  DELTA_LEDS( 66u, PATCH(  0,  0 ) ),
+  EXEC_LEDS( 66u, ( 0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0,  1,  0,  0,  0,  0, -1,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0, -1,  0,  0,  0,  0,  0,  0,  0,  1,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, (-1,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0,  0,  0,  0, -1,  0,  1,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0,  0,  0,  0,  0,  0, -1,  0,  0,  0,  1), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0, -1,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0,  0, -1,  0,  0,  1,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0,  0,  0,  0,  0, -1,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),  //RGB lights up here
+  EXEC_LEDS( 66u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0,  0,  0,  1,  0,  0,  0,  0, -1,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 66u, ( 0,  0,  0,  0, -1,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
 };
 //! \brief Pseudo-random fade animation (red) -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasPseudoRandomFadeRGB[ 4u ] = 
+CODE const U8 gau8PseudoRandomFadeRGB[] = 
 {
-  { 9966u, { 0,  0,  0}, LOAD,  0u },
-  {   66u, { 1,  0,  0}, ADD | REPEAT, 14u },
-  {   66u, {-1,  0,  0}, ADD | REPEAT, 14u },
-  { 1980u, { 0,  0,  0}, LOAD,  0u },
+  LOAD_RGB( 9966u, ( 0,  0,  0) ),
+  FADE_RGB( 990u, (15,  0,  0), EASE_LINEAR ),
+  FADE_RGB( 990u, ( 0,  0,  0), EASE_LINEAR ),
+  LOAD_RGB( 1980u, ( 0,  0,  0) ),
 };
 //! \brief Pseudo-random fade animation (yellow) -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasPseudoRandomFadeRGB_hopehely[ 4u ] = 
+CODE const U8 gau8PseudoRandomFadeRGB_hopehely[] = 
 {
-  { 9966u, { 0,  0,  0}, LOAD,  0u },
-  {   66u, { 1,  1,  0}, ADD | REPEAT, 14u },
-  {   66u, {-1, -1,  0}, ADD | REPEAT, 14u },
-  { 1980u, { 0,  0,  0}, LOAD,  0u },
+  LOAD_RGB( 9966u, ( 0,  0,  0) ),
+  FADE_RGB( 990u, (15, 15,  0), EASE_LINEAR ),
+  FADE_RGB( 990u, ( 0,  0,  0), EASE_LINEAR ),
+  LOAD_RGB( 1980u, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief CrissCross -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasCrissCross[ 12u ] = 
+CODE const U8 gau8CrissCross[] = 
 {
         //0    1   2   3   4   5   6   7   8   9  10  11
-  {350u, {15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD,  0u },
-  {350u, { 0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0, 15,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0}, LOAD,  0u },
+  DELTA_LEDS( 350u, PATCH(  0, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  0,  0 ), PATCH(  2, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  2,  0 ), PATCH(  8, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  4, 15 ), PATCH(  8,  0 ) ),
+  DELTA_LEDS( 350u, PATCH(  4,  0 ), PATCH(  6, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  5, 15 ), PATCH(  6,  0 ) ),
+  DELTA_LEDS( 350u, PATCH(  5,  0 ), PATCH(  7, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  3, 15 ), PATCH(  7,  0 ) ),
+  DELTA_LEDS( 350u, PATCH(  3,  0 ), PATCH(  9, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  9,  0 ), PATCH( 11, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  1, 15 ), PATCH( 11,  0 ) ),
+  DELTA_LEDS( 350u, PATCH( 10, 15 ) ),
 };
 //! \brief CrissCross -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasCrissCrossRGB[ 4u ] = 
+CODE const U8 gau8CrissCrossRGB[] = 
 {
-  { 1050u, { 0, 15, 15}, LOAD,         0u },
-  { 1050u, {15,  0,  0}, LOAD,         0u },
-  { 1050u, { 2, 10, 10}, LOAD,         0u },
-  { 1050u, {15, 15,  0}, LOAD,         0u },
+  LOAD_RGB( 1050u, ( 0, 15, 15) ),
+  LOAD_RGB( 1050u, (15,  0,  0) ),
+  LOAD_RGB( 1050u, ( 2, 10, 10) ),
+  LOAD_RGB( 1050u, (15, 15,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Fadeout -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasFadeout[ 12u ] = 
-{
-  {350u, { 0,  0,  0,  0,  4,  0,  9,  0,  0, 15,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0, 15,  0,  0,  4,  0,  0,  9,  0,  0}, LOAD,  0u },
-  {350u, {15,  0,  0,  9,  0,  0,  0,  0,  0,  4,  0,  0}, LOAD,  0u },
-  {350u, { 9,  0,  0,  4,  0,  0,  0, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 4,  0,  0,  0,  0,  0,  0,  9,  0,  0,  0, 15}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0,  0,  0,  4, 15,  0,  0,  9}, LOAD,  0u },
-  {350u, { 0,  0, 15,  0,  0,  0,  0,  0,  9,  0,  0,  4}, LOAD,  0u },
-  {350u, { 0,  0,  9,  0,  0,  0,  0,  0,  4,  0, 15,  0}, LOAD,  0u },
-  {350u, { 0,  0,  4,  0,  0, 15,  0,  0,  0,  0,  9,  0}, LOAD,  0u },
-  {350u, { 0, 15,  0,  0,  0,  9,  0,  0,  0,  0,  4,  0}, LOAD,  0u },
-  {350u, { 0,  9,  0,  0, 15,  4,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  4,  0,  0,  9,  0, 15,  0,  0,  0,  0,  0}, LOAD,  0u },
+CODE const U8 gau8Fadeout[] = 
+{
+  DELTA_LEDS( 350u, PATCH(  4,  4 ), PATCH(  6,  9 ), PATCH(  9, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  3, 15 ), PATCH(  4,  0 ), PATCH(  6,  4 ), PATCH(  9,  9 ) ),
+  DELTA_LEDS( 350u, PATCH(  0, 15 ), PATCH(  3,  9 ), PATCH(  6,  0 ), PATCH(  9,  4 ) ),
+  DELTA_LEDS( 350u, PATCH(  0,  9 ), PATCH(  3,  4 ), PATCH(  7, 15 ), PATCH(  9,  0 ) ),
+  DELTA_LEDS( 350u, PATCH(  0,  4 ), PATCH(  3,  0 ), PATCH(  7,  9 ), PATCH( 11, 15 ) ),
+  DELTA_LEDS( 350u, PATCH(  0,  0 ), PATCH(  7,  4 ), PATCH(  8, 15 ), PATCH( 11,  9 ) ),
+  DELTA_LEDS( 350u, PATCH(  2, 15 ), PATCH(  7,  0 ), PATCH(  8,  9 ), PATCH( 11,  4 ) ),
+  DELTA_LEDS( 350u, PATCH(  2,  9 ), PATCH(  8,  4 ), PATCH( 10, 15 ), PATCH( 11,  0 ) ),
+  DELTA_LEDS( 350u, PATCH(  2,  4 ), PATCH(  5, 15 ), PATCH(  8,  0 ), PATCH( 10,  9 ) ),
+  DELTA_LEDS( 350u, PATCH(  1, 15 ), PATCH(  2,  0 ), PATCH(  5,  9 ), PATCH( 10,  4 ) ),
+  DELTA_LEDS( 350u, PATCH(  1,  9 ), PATCH(  4, 15 ), PATCH(  5,  4 ), PATCH( 10,  0 ) ),
+  DELTA_LEDS( 350u, PATCH(  1,  4 ), PATCH(  4,  9 ), PATCH(  5,  0 ), PATCH(  6, 15 ) ),
 };
 //! \brief Fadeout -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasFadeoutRGB[ 6u ] = 
+CODE const U8 gau8FadeoutRGB[] = 
 {
-  { 700u, {15, 10,  0}, LOAD,         0u },
-  { 700u, {11,  6,  0}, LOAD,         0u },
-  { 700u, { 4,  2,  0}, LOAD,         0u },
-  { 700u, { 0,  0,  0}, LOAD,         0u },
-  { 700u, { 4,  2,  0}, LOAD,         0u },
-  { 700u, {11,  6,  0}, LOAD,         0u },
+  LOAD_RGB( 700u, (15, 10,  0) ),
+  LOAD_RGB( 700u, (11,  6,  0) ),
+  LOAD_RGB( 700u, ( 4,  2,  0) ),
+  LOAD_RGB( 700u, ( 0,  0,  0) ),
+  LOAD_RGB( 700u, ( 4,  2,  0) ),
+  LOAD_RGB( 700u, (11,  6,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Flicker -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasFlicker[ 10u ] = 
-{
-  {200u, { 0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0}, LOAD,  0u },
-  {200u, { 0,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {200u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0}, LOAD,  0u },
-  {200u, { 0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {200u, {15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {200u, { 0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {200u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD,  0u },
-  {200u, { 0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {200u, { 0,  0,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {200u, { 0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD,  0u },
+CODE const U8 gau8Flicker[] = 
+{
+  GENERATE_LEDS( 200u, GENERATOR_SPARKLE, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), 15u, 0u ),
+  GENERATE_LEDS( 200u, GENERATOR_SPARKLE, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), 15u, 8u ),
 };
 //! \brief Flicker -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasFlickerRGB[ 6u ] = 
+CODE const U8 gau8FlickerRGB[] = 
 {
-  { 400u, {15,  0,  0}, LOAD,         0u },
-  { 100u, {15, 15,  0}, LOAD,         0u },
-  { 800u, {15,  0,  0}, LOAD,         0u },
-  { 100u, {15, 15,  0}, LOAD,         0u },
-  { 500u, {15,  0,  0}, LOAD,         0u },
-  { 100u, {15, 15,  0}, LOAD,         0u },
+  LOAD_RGB( 400u, (15,  0,  0) ),
+  LOAD_RGB( 100u, (15, 15,  0) ),
+  LOAD_RGB( 800u, (15,  0,  0) ),
+  LOAD_RGB( 100u, (15, 15,  0) ),
+  LOAD_RGB( 500u, (15,  0,  0) ),
+  LOAD_RGB( 100u, (15, 15,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Pingpong -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasPingpong[ 12u ] = 
-{
-  {175u, {15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT,4u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {175u, { 0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT,4u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD,  0u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LSHIFT | REPEAT,4u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {175u, { 0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LSHIFT | REPEAT,4u },
-  {175u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
+CODE const U8 gau8Pingpong[] = 
+{
+  DELTA_LEDS( 175u, PATCH(  0, 15 ) ),
+  EXEC_LEDS( 175u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), RSHIFT | REPEAT, 4u ),
+  DELTA_LEDS( 175u, PATCH(  0,  0 ) ),
+  DELTA_LEDS( 175u, PATCH(  6, 15 ) ),
+  EXEC_LEDS( 175u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), RSHIFT | REPEAT, 4u ),
+  DELTA_LEDS( 175u, PATCH(  0,  0 ) ),
+  DELTA_LEDS( 175u, PATCH( 11, 15 ) ),
+  EXEC_LEDS( 175u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), LSHIFT | REPEAT, 4u ),
+  DELTA_LEDS( 175u, PATCH(  0,  0 ) ),
+  DELTA_LEDS( 175u, PATCH(  5, 15 ) ),
+  EXEC_LEDS( 175u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), LSHIFT | REPEAT, 4u ),
+  DELTA_LEDS( 175u, PATCH(  0,  0 ) ),
 };
 //! \brief Pingpong -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasPingpongRGB[ 3u ] = 
+CODE const U8 gau8PingpongRGB[] = 
 {
-  {1050u, {15, 15,  0}, LOAD,         0u },
-  {2450u, { 0, 15, 15}, LOAD,         0u },
-  {1400u, {15, 15,  0}, LOAD,         0u },
+  LOAD_RGB( 1050u, (15, 15,  0) ),
+  LOAD_RGB( 2450u, ( 0, 15, 15) ),
+  LOAD_RGB( 1400u, (15, 15,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Sparkle -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSparkle[ 10u ] = 
-{
-  {200u, { 4,  4,  4,  4, 15,  4,  4,  4,  4,  4,  4,  4}, LOAD,  0u },
-  {200u, { 4, 15,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4}, LOAD,  0u },
-  {200u, { 4,  4,  4,  4,  4,  4, 15,  4,  4,  4,  4,  4}, LOAD,  0u },
-  {200u, { 4,  4,  4,  4,  4,  4,  4,  4,  4,  4, 15,  4}, LOAD,  0u },
-  {200u, { 4,  4, 15,  4,  4,  4,  4,  4,  4,  4,  4,  4}, LOAD,  0u },
-  {200u, {15,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4}, LOAD,  0u },
-  {200u, { 4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4, 15}, LOAD,  0u },
-  {200u, { 4,  4,  4, 15,  4,  4,  4,  4,  4,  4,  4,  4}, LOAD,  0u },
-  {200u, { 4,  4,  4,  4,  4,  4,  4,  4,  4, 15,  4,  4}, LOAD,  0u },
-  {200u, { 4,  4,  4,  4,  4, 15,  4,  4,  4,  4,  4,  4}, LOAD,  0u },
+CODE const U8 gau8Sparkle[] = 
+{
+  GENERATE_LEDS( 200u, GENERATOR_SPARKLE, ( 4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4), 15u, 0u ),
+  GENERATE_LEDS( 200u, GENERATOR_SPARKLE, ( 4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4,  4), 15u, 8u ),
 };
 //! \brief Sparkle -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSparkleRGB[ 6u ] = 
+CODE const U8 gau8SparkleRGB[] = 
 {
-  { 500u, {15,  0,  0}, LOAD,         0u },
-  { 250u, {15,  3,  1}, LOAD,         0u },
-  { 250u, {15,  6,  2}, LOAD,         0u },
-  { 500u, {15, 10,  3}, LOAD,         0u },
-  { 250u, {15,  6,  2}, LOAD,         0u },
-  { 250u, {15,  3,  1}, LOAD,         0u },
+  LOAD_RGB( 500u, (15,  0,  0) ),
+  LOAD_RGB( 250u, (15,  3,  1) ),
+  LOAD_RGB( 250u, (15,  6,  2) ),
+  LOAD_RGB( 500u, (15, 10,  3) ),
+  LOAD_RGB( 250u, (15,  6,  2) ),
+  LOAD_RGB( 250u, (15,  3,  1) ),
 };
 //! \brief Sparkle -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSparkleRGB_hopehely[ 6u ] = 
+CODE const U8 gau8SparkleRGB_hopehely[] = 
 {
-  { 500u, { 0,  0, 15}, LOAD,         0u },
-  { 250u, { 1,  3, 15}, LOAD,         0u },
-  { 250u, { 2,  6, 15}, LOAD,         0u },
-  { 500u, { 3, 10, 15}, LOAD,         0u },
-  { 250u, { 2,  6, 15}, LOAD,         0u },
-  { 250u, { 1,  3, 15}, LOAD,         0u },
+  LOAD_RGB( 500u, ( 0,  0, 15) ),
+  LOAD_RGB( 250u, ( 1,  3, 15) ),
+  LOAD_RGB( 250u, ( 2,  6, 15) ),
+  LOAD_RGB( 500u, ( 3, 10, 15) ),
+  LOAD_RGB( 250u, ( 2,  6, 15) ),
+  LOAD_RGB( 250u, ( 1,  3, 15) ),
 };
 
 //--------------------------------------------------------
 //! \brief Split2 -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSplit2[ 2u ] = 
+CODE const U8 gau8Split2[] = 
 {
-  {500u, {15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0}, LOAD,  0u },
-  {500u, { 0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15}, LOAD,  0u },
+  LOAD_LEDS( 500u, (15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0) ),
+  LOAD_LEDS( 500u, ( 0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15) ),
 };
 //! \brief Split2 -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSplit2RGB[ 3u ] = 
+CODE const U8 gau8Split2RGB[] = 
 {
-  { 333u, {15,  0, 15}, LOAD,         0u },
-  { 333u, { 0, 15, 15}, LOAD,         0u },
-  { 334u, {15, 15,  0}, LOAD,         0u },
+  LOAD_RGB( 333u, (15,  0, 15) ),
+  LOAD_RGB( 333u, ( 0, 15, 15) ),
+  LOAD_RGB( 334u, (15, 15,  0) ),
 };
 
 /*
 //--------------------------------------------------------
 //! \brief Split3fade -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSplit3fade[ 6u ] = 
+CODE const U8 gau8Split3fade[] = 
 {
-  {500u, {15,  4,  0, 15,  4,  0, 15,  4,  0, 15,  4,  0}, LOAD,  0u },
-  {500u, { 0, 15,  4,  0, 15,  4,  0, 15,  4,  0, 15,  4}, LOAD,  0u },
-  {500u, { 0,  0, 15,  4,  0, 15,  4,  0, 15,  4,  0, 15}, LOAD,  0u },
-  {500u, {15,  4,  0, 15,  4,  0, 15,  4,  0, 15,  4,  0}, LOAD,  0u },
-  {500u, { 0, 15,  4,  0, 15,  4,  0, 15,  4,  0, 15,  4}, LOAD,  0u },
-  {500u, { 0,  0, 15,  4,  0, 15,  4,  0, 15,  4,  0, 15}, LOAD,  0u },
+  LOOP( 2u ),
+    LOAD_LEDS( 500u, (15,  4,  0, 15,  4,  0, 15,  4,  0, 15,  4,  0) ),
+    LOAD_LEDS( 500u, ( 0, 15,  4,  0, 15,  4,  0, 15,  4,  0, 15,  4) ),
+    LOAD_LEDS( 500u, ( 0,  0, 15,  4,  0, 15,  4,  0, 15,  4,  0, 15) ),
+  END_LOOP(),
 };
 //! \brief Split3fade -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSplit3fadeRGB[ 6u ] = 
+CODE const U8 gau8Split3fadeRGB[] = 
 {
-  { 500u, {15,  0, 15}, LOAD,         0u },
-  { 500u, { 7,  7, 15}, LOAD,         0u },
-  { 500u, { 0, 15, 15}, LOAD,         0u },
-  { 500u, { 7, 15,  7}, LOAD,         0u },
-  { 500u, {15, 15,  0}, LOAD,         0u },
-  { 500u, {15,  7,  7}, LOAD,         0u },
+  LOAD_RGB( 500u, (15,  0, 15) ),
+  LOAD_RGB( 500u, ( 7,  7, 15) ),
+  LOAD_RGB( 500u, ( 0, 15, 15) ),
+  LOAD_RGB( 500u, ( 7, 15,  7) ),
+  LOAD_RGB( 500u, (15, 15,  0) ),
+  LOAD_RGB( 500u, (15,  7,  7) ),
 };
 */
 
 //--------------------------------------------------------
 //! \brief Stepping -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasStepping[ 2u ] = 
+CODE const U8 gau8Stepping[] = 
 {
-  {350u, {15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {350u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT,10u },
+  DELTA_LEDS( 350u, PATCH(  0, 15 ) ),
+  EXEC_LEDS( 350u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), RSHIFT | REPEAT, 10u ),
 };
 
 
 //! \brief Stepping -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSteppingRGB[ 11u ] = 
+CODE const U8 gau8SteppingRGB[] = 
 {
-  { 350u, {15,  0,  0}, LOAD,         0u },
-  { 350u, {15,  6,  0}, LOAD,         0u },
-  { 350u, {15, 10,  0}, LOAD,         0u },
-  { 350u, {15, 15,  0}, LOAD,         0u },
-  { 350u, { 0, 15,  0}, LOAD,         0u },
-  { 350u, { 0, 10,  0}, LOAD,         0u },
-  { 350u, { 2, 10, 10}, LOAD,         0u },
-  { 350u, { 0, 15, 15}, LOAD,         0u },
-  { 350u, { 7,  5, 10}, LOAD,         0u },
-  { 350u, {15,  0, 15}, LOAD,         0u },
-  { 350u, {15, 12, 12}, LOAD,         0u },
+  LOAD_RGB( 350u, (15,  0,  0) ),
+  LOAD_RGB( 350u, (15,  6,  0) ),
+  LOAD_RGB( 350u, (15, 10,  0) ),
+  LOAD_RGB( 350u, (15, 15,  0) ),
+  LOAD_RGB( 350u, ( 0, 15,  0) ),
+  LOAD_RGB( 350u, ( 0, 10,  0) ),
+  LOAD_RGB( 350u, ( 2, 10, 10) ),
+  LOAD_RGB( 350u, ( 0, 15, 15) ),
+  LOAD_RGB( 350u, ( 7,  5, 10) ),
+  LOAD_RGB( 350u, (15,  0, 15) ),
+  LOAD_RGB( 350u, (15, 12, 12) ),
 };
 
 //--------------------------------------------------------
 //! \brief Race -- A trace is circulating and accelerating
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasRace[ 21u ] = 
-{
-  {100u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 2u },
-  {100u, { 0,  0,  0,  0,  5, 10,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  5, 15,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0, 10, 15,  0,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  5, 10, 15,  0,  0,  0}, LOAD,            0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 4u },
-  {70u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {70u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 2u },
-  {70u, { 0,  0,  0,  0,  5, 10,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {70u, { 0,  0,  0,  0,  0,  5, 15,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {70u, { 0,  0,  0,  0,  0,  0, 10, 15,  0,  0,  0,  0}, LOAD,            0u },
-  {70u, { 0,  0,  0,  0,  0,  0,  5, 10, 15,  0,  0,  0}, LOAD,            0u },
-  {70u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 4u },
-  {40u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {40u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 2u },
-  {40u, { 0,  0,  0,  0,  5, 10,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {40u, { 0,  0,  0,  0,  0,  5, 15,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {40u, { 0,  0,  0,  0,  0,  0, 10, 15,  0,  0,  0,  0}, LOAD,            0u },
-  {40u, { 0,  0,  0,  0,  0,  0,  5, 10, 15,  0,  0,  0}, LOAD,            0u },
-  {40u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 4u },
+CODE const U8 gau8Race[] = 
+{
+  CALL( SUBROUTINE_SHOOTING_STAR ),
+  CALL_SCALED( SUBROUTINE_SHOOTING_STAR, 70u ),
+  CALL_SCALED( SUBROUTINE_SHOOTING_STAR, 40u ),
 };
 //! \brief Race -- RGB
-CODE const S_ANIMATION_INSTRUCTION_RGB gasRaceRGB[ 12u ] = 
+CODE const U8 gau8RaceRGB[] = 
 { 
-  {400u, { 0,  0,  0}, LOAD,            0u },
-  {100u, {15,  0,  0}, LOAD,            0u },
-  {100u, {-5,  0,  0}, ADD | REPEAT,    1u },
-  {600u, { 0,  0,  0}, LOAD,            0u },
-  
-  {280u, { 0,  0,  0}, LOAD,            0u },
-  {70u, {15,  0,  0}, LOAD,            0u },
-  {70u, {-5,  0,  0}, ADD | REPEAT,    1u },
-  {420u, { 0,  0,  0}, LOAD,            0u },
-
-  {160u, { 0,  0,  0}, LOAD,            0u },
-  {40u, {15,  0,  0}, LOAD,            0u },
-  {40u, {-5,  0,  0}, ADD | REPEAT,    1u },
-  {240u, { 0,  0,  0}, LOAD,            0u },
+  CALL( SUBROUTINE_SHOOTING_STAR_RGB ),
+  CALL_SCALED( SUBROUTINE_SHOOTING_STAR_RGB, 70u ),
+  CALL_SCALED( SUBROUTINE_SHOOTING_STAR_RGB, 40u ),
 };
 
 //--------------------------------------------------------
 //! \brief Race -- A trace is circulating and accelerating
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasRace_hopehely[ 6u ] = 
+CODE const U8 gau8Race_hopehely[] = 
 {
-  {100u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,             0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 10u },
-  { 70u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,             0u },
-  { 70u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 10u },
-  { 40u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,             0u },
-  { 40u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 10u },
+  CALL( SUBROUTINE_SHOOTING_STAR_HOPEHELY ),
+  CALL_SCALED( SUBROUTINE_SHOOTING_STAR_HOPEHELY, 70u ),
+  CALL_SCALED( SUBROUTINE_SHOOTING_STAR_HOPEHELY, 40u ),
 };
 //! \brief Race -- RGB
-CODE const S_ANIMATION_INSTRUCTION_RGB gasRaceRGB_hopehely[ 9u ] = 
+CODE const U8 gau8RaceRGB_hopehely[] = 
 { 
-  {90u, { 0,  0,  0}, LOAD,            0u },
-  {37u, { 1,  0,  0}, ADD | REPEAT,   14u },
-  {37u, {-1,  0,  0}, ADD | REPEAT,   14u },
+  LOAD_RGB( 90u, ( 0,  0,  0) ),
+  FADE_RGB( 555u, (15,  0,  0), EASE_LINEAR ),
+  FADE_RGB( 555u, ( 0,  0,  0), EASE_LINEAR ),
 
-  {30u, { 0,  0,  0}, LOAD,            0u },
-  {27u, { 0,  1,  0}, ADD | REPEAT,   14u },
-  {27u, { 0, -1,  0}, ADD | REPEAT,   14u },
+  LOAD_RGB( 30u, ( 0,  0,  0) ),
+  FADE_RGB( 405u, ( 0, 15,  0), EASE_LINEAR ),
+  FADE_RGB( 405u, ( 0,  0,  0), EASE_LINEAR ),
 
-  {30u, { 0,  0,  0}, LOAD,            0u },
-  {15u, { 0,  0,  1}, ADD | REPEAT,   14u },
-  {15u, { 0,  0, -1}, ADD | REPEAT,   14u },
+  LOAD_RGB( 30u, ( 0,  0,  0) ),
+  FADE_RGB( 225u, ( 0,  0, 15), EASE_LINEAR ),
+  FADE_RGB( 225u, ( 0,  0,  0), EASE_LINEAR ),
 };
 
 //--------------------------------------------------------
 //! \brief Ying-yang
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasYingYang[ 2u ] = 
+CODE const U8 gau8YingYang[] = 
 {
-  {150u, { 0,  5, 10, 15,  0,  0,  0,  5, 10, 15,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 4u },
+  LOAD_LEDS( 150u, ( 0,  5, 10, 15,  0,  0,  0,  5, 10, 15,  0,  0) ),
+  EXEC_LEDS( 150u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), RSHIFT | REPEAT, 4u ),
 };
 //! \brief Ying Yang RGB
-CODE const S_ANIMATION_INSTRUCTION_RGB gasYingYangRGB[ 2u ] = 
+CODE const U8 gau8YingYangRGB[] = 
 {
-  { 450u, {2, 6, 15}, LOAD,        0u },
-  { 450u, { 15,  8,  1}, LOAD,     0u },
+  LOAD_RGB( 450u, (2, 6, 15) ),
+  LOAD_RGB( 450u, ( 15,  8,  1) ),
 };
 
 //--------------------------------------------------------
 //! \brief Ice
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasIce[ 11u ] = 
-{
-  {300u, { 0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {300u, { 0,  0,  0,  0, 15, 10,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {300u, { 0,  0,  0, 15, 10,  5, 15,  0,  0,  0,  0,  0}, LOAD, 0u },
-  {300u, { 0,  0, 15, 10,  5,  0, 10, 15,  0,  0,  0,  0}, LOAD, 0u },
-  {300u, { 0, 15, 10,  5,  0,  0,  5, 10, 15,  0,  0,  0}, LOAD, 0u },
-  {300u, {15, 10,  5,  0,  0,  0,  0,  5, 10, 15,  0,  0}, LOAD, 0u },
-  {300u, {15,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15,  0}, LOAD, 0u },
-  {300u, {15,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10, 15}, LOAD, 0u },
-  {300u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5, 15}, LOAD, 0u },
-  {300u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD, 0u },
-  {300u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
+CODE const U8 gau8Ice[] = 
+{
+  DELTA_LEDS( 300u, PATCH(  5, 15 ) ),
+  DELTA_LEDS( 300u, PATCH(  4, 15 ), PATCH(  5, 10 ) ),
+  DELTA_LEDS( 300u, PATCH(  3, 15 ), PATCH(  4, 10 ), PATCH(  5,  5 ), PATCH(  6, 15 ) ),
+  LOAD_LEDS( 300u, ( 0,  0, 15, 10,  5,  0, 10, 15,  0,  0,  0,  0) ),
+  LOAD_LEDS( 300u, ( 0, 15, 10,  5,  0,  0,  5, 10, 15,  0,  0,  0) ),
+  LOAD_LEDS( 300u, (15, 10,  5,  0,  0,  0,  0,  5, 10, 15,  0,  0) ),
+  LOAD_LEDS( 300u, (15,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15,  0) ),
+  LOAD_LEDS( 300u, (15,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10, 15) ),
+  DELTA_LEDS( 300u, PATCH(  0,  0 ), PATCH(  9,  0 ), PATCH( 10,  5 ) ),
+  DELTA_LEDS( 300u, PATCH( 10,  0 ) ),
+  DELTA_LEDS( 300u, PATCH( 11,  0 ) ),
 };
 //! \brief Ice
-CODE const S_ANIMATION_INSTRUCTION_RGB gasIceRGB[ 2u ] = 
+CODE const U8 gau8IceRGB[] = 
 {
-  { 194u, {0, 15, 15}, LOAD,        0u },
-  { 194u, { 0,  -1,  0}, ADD | REPEAT,     15u },
-//  { 88u, {0, 0, 15}, LOAD,        0u },
-//  { 88u, { 0,  1,  0}, ADD | REPEAT,     15u },
+  LOAD_RGB( 194u, (0, 15, 15) ),
+  EXEC_RGB( 194u, ( 0,  -1,  0), ADD | REPEAT, 15u ),
+//  LOAD_RGB( 88u, (0, 0, 15) ),
+//  EXEC_RGB( 88u, ( 0,  1,  0), ADD | REPEAT, 15u ),
 };
 
 //--------------------------------------------------------
 //! \brief Ice
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasIce_hopehely[ 10u ] = 
-{
-  {300u, { 0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD, 0u },
-  {300u, { 0,  0,  0,  0,  0, 15, 10, 15,  0,  0,  0,  0}, LOAD, 0u },
-  {300u, { 0,  0,  0,  0, 15, 10,  5, 10, 15,  0,  0,  0}, LOAD, 0u },
-  {300u, { 0,  0,  0, 15, 10,  5,  0,  5, 10, 15,  0,  0}, LOAD, 0u },
-  {300u, { 0,  0, 15, 10,  5,  0,  0,  0,  5, 10, 15,  0}, LOAD, 0u },
-  {300u, { 0, 15, 10,  5,  0,  0,  0,  0,  0,  5, 10, 15}, LOAD, 0u },
-  {300u, {15, 10,  5,  0,  0,  0,  0,  0,  0,  0,  5, 10}, LOAD, 0u },
-  {300u, {10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, LOAD, 0u },
-  {300u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD, 0u },
-  {300u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD, 0u },
+CODE const U8 gau8Ice_hopehely[] = 
+{
+  DELTA_LEDS( 300u, PATCH(  6, 15 ) ),
+  DELTA_LEDS( 300u, PATCH(  5, 15 ), PATCH(  6, 10 ), PATCH(  7, 15 ) ),
+  LOAD_LEDS( 300u, ( 0,  0,  0,  0, 15, 10,  5, 10, 15,  0,  0,  0) ),
+  LOAD_LEDS( 300u, ( 0,  0,  0, 15, 10,  5,  0,  5, 10, 15,  0,  0) ),
+  LOAD_LEDS( 300u, ( 0,  0, 15, 10,  5,  0,  0,  0,  5, 10, 15,  0) ),
+  LOAD_LEDS( 300u, ( 0, 15, 10,  5,  0,  0,  0,  0,  0,  5, 10, 15) ),
+  LOAD_LEDS( 300u, (15, 10,  5,  0,  0,  0,  0,  0,  0,  0,  5, 10) ),
+  LOAD_LEDS( 300u, (10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5) ),
+  DELTA_LEDS( 300u, PATCH(  0,  5 ), PATCH(  1,  0 ), PATCH( 11,  0 ) ),
+  DELTA_LEDS( 300u, PATCH(  0,  0 ) ),
 };
 //! \brief Ice RGB
-CODE const S_ANIMATION_INSTRUCTION_RGB gasIceRGB_hopehely[ 4u ] = 
+CODE const U8 gau8IceRGB_hopehely[] = 
 {
-  { 105u, { 0, 15, 15}, LOAD,          0u },
-  {  93u, { 0, -1,  0}, ADD | REPEAT, 14u },
-  { 105u, { 0,  0, 15}, LOAD,          0u },
-  {  93u, { 0,  1,  0}, ADD | REPEAT, 14u },
+  LOAD_RGB( 105u, ( 0, 15, 15) ),
+  FADE_RGB( 1395u, ( 0,  0, 15), EASE_LINEAR ),
+  LOAD_RGB( 105u, ( 0,  0, 15) ),
+  FADE_RGB( 1395u, ( 0, 15, 15), EASE_LINEAR ),
 };
 
 //--------------------------------------------------------
 //! \brief All blackness, reached right before going to power down mode -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasBlackness[ 1u ] =
+CODE const U8 gau8Blackness[] =
 {
-  {0xFFFFu, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD, 0u },
+  DELTA_LEDS( 0xFFFFu, PATCH(  0,  0 ) ),
 };
 //! \brief All blackness, reached right before going to power down mode -- RGB LED
-CODE const S_ANIMATION_INSTRUCTION_RGB gasBlacknessRGB[ 1u ] =
+CODE const U8 gau8BlacknessRGB[] =
 {
-  {0xFFFFu, { 0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 0xFFFFu, ( 0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Shooting star anticlockwise animation -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasShootingStar_hopehely[ 2u ] = 
+CODE const U8 gau8ShootingStar_hopehely[] = 
 { 
-  {100u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,             0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, RSHIFT | REPEAT, 10u },
+  DELTA_LEDS( 100u, PATCH(  0,  5 ), PATCH(  1, 10 ), PATCH(  2, 15 ) ),
+  EXEC_LEDS( 100u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), RSHIFT | REPEAT, 10u ),
 };
 //! \brief 20 step Rainbow, 1000ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_RGB gasShootingStar_hopehely_RGB[ 20u ] = 
-{
- { 50u, {15,  0,  0}, LOAD, 0u },
- { 50u, {15,  5,  0}, LOAD, 0u },
- { 50u, {15,  9,  0}, LOAD, 0u },
- { 50u, {15, 13,  0}, LOAD, 0u },
- { 50u, {12, 15,  0}, LOAD, 0u },
- { 50u, { 8, 15,  0}, LOAD, 0u },
- { 50u, { 3, 15,  0}, LOAD, 0u },
- { 50u, { 0, 15,  1}, LOAD, 0u },
- { 50u, { 0, 15,  6}, LOAD, 0u },
- { 50u, { 0, 15, 11}, LOAD, 0u },
- { 50u, { 0, 15, 15}, LOAD, 0u },
- { 50u, { 0, 10, 15}, LOAD, 0u },
- { 50u, { 0,  6, 15}, LOAD, 0u },
- { 50u, { 0,  1, 15}, LOAD, 0u },
- { 50u, { 3,  0, 15}, LOAD, 0u },
- { 50u, { 8,  0, 15}, LOAD, 0u },
- { 50u, {12,  0, 15}, LOAD, 0u },
- { 50u, {15,  0, 14}, LOAD, 0u },
- { 50u, {15,  0,  9}, LOAD, 0u },
- { 50u, {15,  0,  5}, LOAD, 0u }
+CODE const U8 gau8ShootingStar_hopehely_RGB[] = 
+{
+ LOAD_RGB( 50u, (15,  0,  0) ),
+ LOAD_RGB( 50u, (15,  5,  0) ),
+ LOAD_RGB( 50u, (15,  9,  0) ),
+ LOAD_RGB( 50u, (15, 13,  0) ),
+ LOAD_RGB( 50u, (12, 15,  0) ),
+ LOAD_RGB( 50u, ( 8, 15,  0) ),
+ LOAD_RGB( 50u, ( 3, 15,  0) ),
+ LOAD_RGB( 50u, ( 0, 15,  1) ),
+ LOAD_RGB( 50u, ( 0, 15,  6) ),
+ LOAD_RGB( 50u, ( 0, 15, 11) ),
+ LOAD_RGB( 50u, ( 0, 15, 15) ),
+ LOAD_RGB( 50u, ( 0, 10, 15) ),
+ LOAD_RGB( 50u, ( 0,  6, 15) ),
+ LOAD_RGB( 50u, ( 0,  1, 15) ),
+ LOAD_RGB( 50u, ( 3,  0, 15) ),
+ LOAD_RGB( 50u, ( 8,  0, 15) ),
+ LOAD_RGB( 50u, (12,  0, 15) ),
+ LOAD_RGB( 50u, (15,  0, 14) ),
+ LOAD_RGB( 50u, (15,  0,  9) ),
+ LOAD_RGB( 50u, (15,  0,  5) )
   // USOURCE | REPEAT could be used here, but it would be complicated and a bit wrong due 12 steps
 };
 
 //--------------------------------------------------------
 //! \brief One led going around for "hoember", not including eyes at 1001ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasStepping_hoember[ 11u ] = 
+CODE const U8 gau8Stepping_hoember[] = 
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11 
-  {91u, { 15,  0,  0,  0,  0,  8,  8,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0, 15,  0,  0,  0,  8,  8,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0, 15,  0,  0,  8,  8,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0, 15,  0,  8,  8,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0,  0, 15,  8,  8,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0,  0,  0,  8,  8,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0,  0,  0,  8,  8, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0,  0,  0,  8,  8,  0, 15,  0,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0,  0,  0,  8,  8,  0,  0, 15,  0,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0,  0,  0,  8,  8,  0,  0,  0, 15,  0}, LOAD,  0u },
-  {91u, {  0,  0,  0,  0,  0,  8,  8,  0,  0,  0,  0, 15}, LOAD,  0u },
+  DELTA_LEDS( 91u, PATCH(  0, 15 ), PATCH(  5,  8 ), PATCH(  6,  8 ) ),
+  DELTA_LEDS( 91u, PATCH(  0,  0 ), PATCH(  1, 15 ) ),
+  DELTA_LEDS( 91u, PATCH(  1,  0 ), PATCH(  2, 15 ) ),
+  DELTA_LEDS( 91u, PATCH(  2,  0 ), PATCH(  3, 15 ) ),
+  DELTA_LEDS( 91u, PATCH(  3,  0 ), PATCH(  4, 15 ) ),
+  DELTA_LEDS( 91u, PATCH(  4,  0 ) ),
+  DELTA_LEDS( 91u, PATCH(  7, 15 ) ),
+  DELTA_LEDS( 91u, PATCH(  7,  0 ), PATCH(  8, 15 ) ),
+  DELTA_LEDS( 91u, PATCH(  8,  0 ), PATCH(  9, 15 ) ),
+  DELTA_LEDS( 91u, PATCH(  9,  0 ), PATCH( 10, 15 ) ),
+  DELTA_LEDS( 91u, PATCH( 10,  0 ), PATCH( 11, 15 ) ),
 };
 //! \brief 20 step Rainbow, 1000ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_RGB gasStepping_hoember_RGB[ 20u ] = 
+CODE const U8 gau8Stepping_hoember_RGB[] = 
 {
- { 455u, {0, 0, 0}, LOAD, 0u },
- { 91u, {8, 8, 0}, LOAD, 0u },
- { 455u, {0, 0, 0}, LOAD, 0u },
+ LOAD_RGB( 455u, (0, 0, 0) ),
+ LOAD_RGB( 91u, (8, 8, 0) ),
+ LOAD_RGB( 455u, (0, 0, 0) ),
   // USOURCE | REPEAT could be used here, but it would be complicated and a bit wrong due 12 steps
 };
 
 //--------------------------------------------------------
 //! \brief One led going around for "mezi" (eyes included) at 1000ms per cycle, while buttons are dimming in offset
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasStepping_mezi[ 11u ] = 
-{
-  {100u, { 15,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 12,  3,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  9,  6,  0,  0, 15,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  6,  9,  0,  0, 0,  15,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  3, 12,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  0, 15,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  3, 12,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0}, LOAD,  0u },
-  {100u, {  6,  9,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD,  0u },
-  {100u, {  9,  6,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0}, LOAD,  0u },
-  {100u, { 12,  3,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD,  0u },
+CODE const U8 gau8Stepping_mezi[] = 
+{
+  TRACK( SUBROUTINE_BUTTONS_MEZI, LED_BIT( 0u ) | LED_BIT( 1u ) ),
+  DELTA_LEDS( 100u, PATCH(  2, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  2,  0 ), PATCH(  3, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  3,  0 ), PATCH(  4, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  4,  0 ), PATCH(  5, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  5,  0 ), PATCH(  6, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  6,  0 ), PATCH(  7, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  7,  0 ), PATCH(  8, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  8,  0 ), PATCH(  9, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  9,  0 ), PATCH( 10, 15 ) ),
+  DELTA_LEDS( 100u, PATCH( 10,  0 ), PATCH( 11, 15 ) ),
+};
+//! \brief The buttons of "mezi" dimming in offset, an own track of gau8Stepping_mezi[]
+CODE const U8 gau8Buttons_mezi[] = 
+{
+  LOAD_LEDS( 100u, (15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0) ),
+  EXEC_LEDS( 100u, (-3,  3,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 4u ),
+  EXEC_LEDS( 100u, ( 3, -3,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 3u ),
 };
 //! \brief no RGB on "mezi"
-CODE const S_ANIMATION_INSTRUCTION_RGB gasStepping_mezi_RGB[ 2u ] = 
+CODE const U8 gau8Stepping_mezi_RGB[] = 
 {
-  { 1000u, {0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 1000u, (0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief One led going around for "ajandekcsomag" at 996 ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasStepping_ajandek[ 12u ] = 
+CODE const U8 gau8Stepping_ajandek[] = 
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11 
-  {83u, { 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0}, LOAD,  0u },
-  {83u, {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD,  0u },
+  DELTA_LEDS( 83u, PATCH(  0, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  0,  0 ), PATCH(  1, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  1,  0 ), PATCH(  2, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  2,  0 ), PATCH(  3, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  3,  0 ), PATCH(  4, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  4,  0 ), PATCH(  5, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  5,  0 ), PATCH(  6, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  6,  0 ), PATCH(  7, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  7,  0 ), PATCH(  8, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  8,  0 ), PATCH(  9, 15 ) ),
+  DELTA_LEDS( 83u, PATCH(  9,  0 ), PATCH( 10, 15 ) ),
+  DELTA_LEDS( 83u, PATCH( 10,  0 ), PATCH( 11, 15 ) ),
 };
 //! \brief no RGB on "ajandek"
-CODE const S_ANIMATION_INSTRUCTION_RGB gasStepping_ajandek_RGB[ 2u ] = 
+CODE const U8 gau8Stepping_ajandek_RGB[] = 
 {
-  { 1000u, {0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 1000u, (0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Two leds going around on two sides in tandem bottom up - then from top to bottom for "Hopehely" at 1200ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasKITT_hopehely[ 12u ] = 
+CODE const U8 gau8KITT_hopehely[] = 
 {
   //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {100u, { 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD,  0u },
-  {100u, {  0,  0, 15,  0,  0,  0,  0,  0,  0,  0, 15,  0}, LOAD,  0u },
-  {100u, {  0,  0,  0, 15,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD,  0u },
-  {100u, {  0,  0,  0,  0, 15,  0,  0,  0, 15,  0,  0,  0}, LOAD,  0u },
-  {100u, {  0,  0,  0,  0,  0, 15,  0, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  0,  0,  0,  0,  0,  0, 15,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  0,  0,  0,  0,  0, 15,  0, 15,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, {  0,  0,  0,  0, 15,  0,  0,  0, 15,  0,  0,  0}, LOAD,  0u },
-  {100u, {  0,  0,  0, 15,  0,  0,  0,  0,  0, 15,  0,  0}, LOAD,  0u },
-  {100u, {  0,  0, 15,  0,  0,  0,  0,  0,  0,  0, 15,  0}, LOAD,  0u },
-  {100u, {  0, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15}, LOAD,  0u },
+  DELTA_LEDS( 100u, PATCH(  0, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  0,  0 ), PATCH(  1, 15 ), PATCH( 11, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  1,  0 ), PATCH(  2, 15 ), PATCH( 10, 15 ), PATCH( 11,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  2,  0 ), PATCH(  3, 15 ), PATCH(  9, 15 ), PATCH( 10,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  3,  0 ), PATCH(  4, 15 ), PATCH(  8, 15 ), PATCH(  9,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  4,  0 ), PATCH(  5, 15 ), PATCH(  7, 15 ), PATCH(  8,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  5,  0 ), PATCH(  6, 15 ), PATCH(  7,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  5, 15 ), PATCH(  6,  0 ), PATCH(  7, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  4, 15 ), PATCH(  5,  0 ), PATCH(  7,  0 ), PATCH(  8, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  3, 15 ), PATCH(  4,  0 ), PATCH(  8,  0 ), PATCH(  9, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  2, 15 ), PATCH(  3,  0 ), PATCH(  9,  0 ), PATCH( 10, 15 ) ),
+  DELTA_LEDS( 100u, PATCH(  1, 15 ), PATCH(  2,  0 ), PATCH( 10,  0 ), PATCH( 11, 15 ) ),
 };
 //! \brief constant orange
-CODE const S_ANIMATION_INSTRUCTION_RGB gasKITT_hopehely_RGB[ 4u ] = 
+CODE const U8 gau8KITT_hopehely_RGB[] = 
 {
-  { 100u, {8, 8, 0}, LOAD, 0u },
-  { 500u, {0, 0, 0}, LOAD, 0u },
-  { 100u, {8, 8, 0}, LOAD, 0u },
-  { 500u, {0, 0, 0}, LOAD, 0u },
+  LOOP( 2u ),
+    LOAD_RGB( 100u, (8, 8, 0) ),
+    LOAD_RGB( 500u, (0, 0, 0) ),
+  END_LOOP(),
 };
 
 //--------------------------------------------------------
 //! \brief Inner and outer leds are fading in offset on "hopehely" at 2000ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSplit2_fade_hopehely[ 10u ] = 
+CODE const U8 gau8Split2_fade_hopehely[] = 
 {
   //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {200u, { 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0}, LOAD,  0u },
-  {200u, { 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3}, LOAD,  0u },
-  {200u, {  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6}, LOAD,  0u },
-  {200u, {  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9}, LOAD,  0u },
-  {200u, {  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12}, LOAD,  0u },
-  {200u, {  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15}, LOAD,  0u },
-  {200u, {  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12}, LOAD,  0u },
-  {200u, {  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9}, LOAD,  0u },
-  {200u, {  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6}, LOAD,  0u },
-  {200u, { 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3}, LOAD,  0u },
+  LOAD_LEDS( 200u, ( 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0) ),
+  LOAD_LEDS( 200u, ( 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3) ),
+  LOAD_LEDS( 200u, (  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6) ),
+  LOAD_LEDS( 200u, (  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9) ),
+  LOAD_LEDS( 200u, (  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12) ),
+  LOAD_LEDS( 200u, (  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15) ),
+  LOAD_LEDS( 200u, (  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12) ),
+  LOAD_LEDS( 200u, (  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9) ),
+  LOAD_LEDS( 200u, (  9,  6,  9,  6,  9,  6,  9,  6,  9,  6,  9,  6) ),
+  LOAD_LEDS( 200u, ( 12,  3, 12,  3, 12,  3, 12,  3, 12,  3, 12,  3) ),
 };
 //! \brief 10 step red fade, 2000ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSplit2_fade_hopehely_RGB[ 10u ] = 
-{
- {200u, { 15, 15, 15}, LOAD, 0u },
- {200u, { 12, 12, 15}, LOAD, 0u },
- {200u, {  9,  9, 15}, LOAD, 0u },
- {200u, {  6,  6, 15}, LOAD, 0u },
- {200u, {  3,  3, 15}, LOAD, 0u },
- {200u, {  0,  0, 15}, LOAD, 0u },
- {200u, {  3,  3, 15}, LOAD, 0u },
- {200u, {  6,  6, 15}, LOAD, 0u },
- {200u, {  9,  9, 15}, LOAD, 0u },
- {200u, { 12, 12, 15}, LOAD, 0u },
+CODE const U8 gau8Split2_fade_hopehely_RGB[] = 
+{
+ LOAD_RGB( 200u, ( 15, 15, 15) ),
+ LOAD_RGB( 200u, ( 12, 12, 15) ),
+ LOAD_RGB( 200u, (  9,  9, 15) ),
+ LOAD_RGB( 200u, (  6,  6, 15) ),
+ LOAD_RGB( 200u, (  3,  3, 15) ),
+ LOAD_RGB( 200u, (  0,  0, 15) ),
+ LOAD_RGB( 200u, (  3,  3, 15) ),
+ LOAD_RGB( 200u, (  6,  6, 15) ),
+ LOAD_RGB( 200u, (  9,  9, 15) ),
+ LOAD_RGB( 200u, ( 12, 12, 15) ),
   // USOURCE | REPEAT could be used here, but it would be complicated and a bit wrong due 12 steps
 };
 
 //--------------------------------------------------------
 //! \brief Inner and outer leds are fading in offset on "hopehely" at 2000ms per cycle (easing variant)
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSplit2_fade_ease_hopehely[ 10u ] = 
+CODE const U8 gau8Split2_fade_ease_hopehely[] = 
 {
   // Alternative, with ease in-out.
   //        0, 1,  2, 3,  4, 5,  6, 7,  8, 9, 10, 11
-  {200u, { 15, 0, 15, 0, 15, 0, 15, 0, 15, 0, 15, 0}, LOAD, 0u },
-  {200u, { 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2}, LOAD, 0u },
-  {200u, { 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5}, LOAD, 0u },
-  {200u, { 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10}, LOAD, 0u },
-  {200u, { 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13}, LOAD, 0u },
-  {200u, { 0, 15, 0, 15, 0, 15, 0, 15, 0, 15, 0, 15}, LOAD, 0u },
-  {200u, { 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13}, LOAD, 0u },
-  {200u, { 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10}, LOAD, 0u },
-  {200u, { 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5}, LOAD, 0u },
-  {200u, { 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2}, LOAD, 0u },
+  LOAD_LEDS( 200u, ( 15, 0, 15, 0, 15, 0, 15, 0, 15, 0, 15, 0) ),
+  LOAD_LEDS( 200u, ( 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2) ),
+  LOAD_LEDS( 200u, ( 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5) ),
+  LOAD_LEDS( 200u, ( 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10) ),
+  LOAD_LEDS( 200u, ( 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13) ),
+  LOAD_LEDS( 200u, ( 0, 15, 0, 15, 0, 15, 0, 15, 0, 15, 0, 15) ),
+  LOAD_LEDS( 200u, ( 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13) ),
+  LOAD_LEDS( 200u, ( 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10) ),
+  LOAD_LEDS( 200u, ( 10, 5, 10, 5, 10, 5, 10, 5, 10, 5, 10, 5) ),
+  LOAD_LEDS( 200u, ( 13, 2, 13, 2, 13, 2, 13, 2, 13, 2, 13, 2) ),
 };
 //! \brief 10 step red fade (eased), 2000ms per cycle
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSplit2_fade_ease_hopehely_RGB[ 10u ] = 
-{
- {200u, { 15, 15, 0}, LOAD, 0u },
- {200u, { 13, 13, 0}, LOAD, 0u },
- {200u, { 10, 10, 0}, LOAD, 0u },
- {200u, {  5,  5, 0}, LOAD, 0u },
- {200u, {  2,  2, 0}, LOAD, 0u },
- {200u, {  0,  0, 0}, LOAD, 0u },
- {200u, {  2,  2, 0}, LOAD, 0u },
- {200u, {  5,  5, 0}, LOAD, 0u },
- {200u, { 10, 10, 0}, LOAD, 0u },
- {200u, { 13, 13, 0}, LOAD, 0u },
+CODE const U8 gau8Split2_fade_ease_hopehely_RGB[] = 
+{
+ LOAD_RGB( 200u, ( 15, 15, 0) ),
+ LOAD_RGB( 200u, ( 13, 13, 0) ),
+ LOAD_RGB( 200u, ( 10, 10, 0) ),
+ LOAD_RGB( 200u, (  5,  5, 0) ),
+ LOAD_RGB( 200u, (  2,  2, 0) ),
+ LOAD_RGB( 200u, (  0,  0, 0) ),
+ LOAD_RGB( 200u, (  2,  2, 0) ),
+ LOAD_RGB( 200u, (  5,  5, 0) ),
+ LOAD_RGB( 200u, ( 10, 10, 0) ),
+ LOAD_RGB( 200u, ( 13, 13, 0) ),
   // USOURCE | REPEAT could be used here, but it would be complicated and a bit wrong due 12 steps
 };
 
 //--------------------------------------------------------
 //! \brief Split2 -- normal LEDs for "mezi"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSplit2_mezi[ 2u ] = 
+CODE const U8 gau8Split2_mezi[] = 
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {500u, {15,  0, 15,  0, 15,  0,  8,  8, 15,  0, 15,  0}, LOAD,  0u },
-  {500u, { 0, 15,  0, 15,  0, 15,  8,  8,  0, 15,  0, 15}, LOAD,  0u },
+  LOAD_LEDS( 500u, (15,  0, 15,  0, 15,  0,  8,  8, 15,  0, 15,  0) ),
+  LOAD_LEDS( 500u, ( 0, 15,  0, 15,  0, 15,  8,  8,  0, 15,  0, 15) ),
 };
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSplit2_mezi_RGB[ 2u ] = 
+CODE const U8 gau8Split2_mezi_RGB[] = 
 {
-  { 1000u, {0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 1000u, (0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief Split2 -- normal LEDs for "ajandekcsomag"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSplit2_ajandek[ 2u ] = 
+CODE const U8 gau8Split2_ajandek[] = 
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {500u, {15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0}, LOAD,  0u },
-  {500u, { 0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15}, LOAD,  0u },
+  LOAD_LEDS( 500u, (15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0) ),
+  LOAD_LEDS( 500u, ( 0, 15,  0, 15,  0, 15,  0, 15,  0, 15,  0, 15) ),
 };
 
 //--------------------------------------------------------
 //! \brief OpenClose -- normal LEDs for "ajandekcsomag"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasOpenClose_ajandek[14u] =
+CODE const U8 gau8OpenClose_ajandek[] =
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {100u, {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD,  0u },
-  { 30u, {-1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1}, ADD | REPEAT, 14u },
-  { 30u, { 0, -1,  0,  0,  0,  0,  0,  0,  0,  0, -1,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0, -1,  0,  0,  0,  0,  0,  0, -1,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0, -1,  0,  0, -1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0, -1, -1,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0, -1,  0,  0,  0,  0, -1,  0,  0,  0}, ADD | REPEAT, 14u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  { 30u, { 0,  0,  0,  1,  0,  0,  0,  0,  1,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  1,  1,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  1,  0,  0,  1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  1,  0,  0,  0,  0,  0,  0,  1,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0}, ADD | REPEAT, 14u },
-  { 30u, { 1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1}, ADD | REPEAT, 14u },
+  LOAD_LEDS( 100u, (15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15) ),
+  FADE_LEDS( 450u, ( 0, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  0), EASE_LINEAR ),
+  FADE_LEDS( 450u, ( 0,  0, 15, 15, 15, 15, 15, 15, 15, 15,  0,  0), EASE_LINEAR ),
+  FADE_LEDS( 450u, ( 0,  0,  0, 15, 15, 15, 15, 15, 15,  0,  0,  0), EASE_LINEAR ),
+  FADE_LEDS( 450u, ( 0,  0,  0, 15,  0, 15, 15,  0, 15,  0,  0,  0), EASE_LINEAR ),
+  FADE_LEDS( 450u, ( 0,  0,  0, 15,  0,  0,  0,  0, 15,  0,  0,  0), EASE_LINEAR ),
+  EXEC_LEDS( 30u, ( 0,  0,  0, -1,  0,  0,  0,  0, -1,  0,  0,  0), ADD | REPEAT, 14u ),
+  DELTA_LEDS( 100u, PATCH(  3,  0 ), PATCH(  8,  0 ) ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  1,  0,  0,  0,  0,  1,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  1,  1,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  1,  0,  0,  1,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  1,  0,  0,  0,  0,  0,  0,  1,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1), ADD | REPEAT, 14u ),
 };
 
 //--------------------------------------------------------
 //! \brief Masni -- normal LEDs for "ajandekcsomag"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasMasni[9u] =
+CODE const U8 gau8Masni[] =
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  { 30u, { 1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1}, ADD | REPEAT, 14u },
-  { 30u, {-1,  1,  0,  0,  0,  0,  0,  0,  0,  0,  1, -1}, ADD | REPEAT, 14u },
-  { 30u, { 0, -1,  1,  0,  0,  0,  0,  0,  0,  1, -1,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0, -1,  1,  0,  0,  0,  0,  1, -1,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0, -1,  1,  0,  0,  1, -1,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0, -1,  1,  1, -1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  1,  0, -1, -1,  0,  1,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0, -1,  0,  0,  0,  0, -1,  0,  0,  0}, ADD | REPEAT, 14u },
+  DELTA_LEDS( 100u, PATCH(  0,  0 ) ),
+  EXEC_LEDS( 30u, ( 1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, (-1,  1,  0,  0,  0,  0,  0,  0,  0,  0,  1, -1), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0, -1,  1,  0,  0,  0,  0,  0,  0,  1, -1,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0, -1,  1,  0,  0,  0,  0,  1, -1,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0, -1,  1,  0,  0,  1, -1,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0, -1,  1,  1, -1,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  1,  0, -1, -1,  0,  1,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0, -1,  0,  0,  0,  0, -1,  0,  0,  0), ADD | REPEAT, 14u ),
 };
 
 //--------------------------------------------------------
 //! \brief AroundFill -- normal LEDs for "ajandekcsomag"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasAroundFill_ajandek[14u] =
+CODE const U8 gau8AroundFill_ajandek[] =
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  { 30u, { 0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1}, ADD | REPEAT, 14u },
-  { 30u, { 1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  { 30u, { 0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0}, ADD | REPEAT, 14u },
-  {200u, {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD,  0u },
+  DELTA_LEDS( 100u, PATCH(  0,  0 ) ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 30u, ( 0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  0,  0), ADD | REPEAT, 14u ),
+  LOAD_LEDS( 200u, (15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15) ),
 };
 
 //--------------------------------------------------------
 //! \brief Around -- normal LEDs for "ajandekcsomag"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasAround_ajandek[15u] =
+CODE const U8 gau8Around_ajandek[] =
 {
  //        0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  { 25u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {  5u, { 0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0, -1,  0,  0,  0,  1,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0,  0,  0,  0, -1,  0,  0,  1,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0,  0,  0,  0,  0, -1,  0,  0,  1,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0,  0,  0,  0,  0,  0,  0, -1,  0,  1}, ADD | REPEAT, 14u },
-  {  5u, { 1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1}, ADD | REPEAT, 14u },
-  {  5u, {-1,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0, -1,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0, -1,  0,  0,  1,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0,  0, -1,  0,  0,  0,  1,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0,  0,  0, -1,  0,  0,  0,  0,  0,  0}, ADD | REPEAT, 14u },
-  {  5u, { 0,  0,  0,  0,  0,  0,  0,  0, -1,  0,  0,  0}, ADD | REPEAT, 14u },
+  DELTA_LEDS( 25u, PATCH(  0,  0 ) ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  0,  0,  0,  1,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0, -1,  0,  0,  0,  1,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  0,  0,  0, -1,  0,  0,  1,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  0,  0,  0,  0, -1,  0,  0,  1,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  0,  0,  0,  0,  0,  0, -1,  0,  1), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0, -1), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, (-1,  0,  1,  0,  0,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0, -1,  0,  0,  1,  0,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0, -1,  0,  0,  1,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  0, -1,  0,  0,  0,  1,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  0,  0, -1,  0,  0,  0,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS(  5u, ( 0,  0,  0,  0,  0,  0,  0,  0, -1,  0,  0,  0), ADD | REPEAT, 14u ),
 };
 
 //--------------------------------------------------------
 //! \brief Split2 -- normal LEDs for "Rudolf"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSplit2_rudolf[ 2u ] = 
+CODE const U8 gau8Split2_rudolf[] = 
 {
-  {500u, {15,  0, 15,  0,   0,  0, 15,  15, 15,  0, 15,  0}, LOAD,  0u },
-  {500u, { 0, 15,  0, 15,  15, 15,  0,   0,  0, 15,  0, 15}, LOAD,  0u },
+  LOAD_LEDS( 500u, (15,  0, 15,  0,   0,  0, 15,  15, 15,  0, 15,  0) ),
+  LOAD_LEDS( 500u, ( 0, 15,  0, 15,  15, 15,  0,   0,  0, 15,  0, 15) ),
 };
 
 //--------------------------------------------------------
 //! \brief Generic flasher animation with dimmed eyes for "mezi"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasFlasherNoEyes_mezi[ 2u ] = 
+CODE const U8 gau8FlasherNoEyes_mezi[] = 
 {
    //      0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11
-  {500u, {15, 15, 15, 15, 15, 15,  8,  8, 15, 15, 15, 15}, LOAD, 0u }, 
-  {500u, { 0,  0,  0,  0,  0,  0,  8,  8,  0,  0,  0,  0}, LOAD, 0u },
+  LOAD_LEDS( 500u, (15, 15, 15, 15, 15, 15,  8,  8, 15, 15, 15, 15) ),
+  LOAD_LEDS( 500u, ( 0,  0,  0,  0,  0,  0,  8,  8,  0,  0,  0,  0) ),
 };
-CODE const S_ANIMATION_INSTRUCTION_RGB gasFlasherNoEyes_mezi_RGB[ 2u ] = 
+CODE const U8 gau8FlasherNoEyes_mezi_RGB[] = 
 {
-  { 1000u, {0,  0,  0}, LOAD, 0u },
+  LOAD_RGB( 1000u, (0,  0,  0) ),
 };
 
 //--------------------------------------------------------
 //! \brief RudolfIntro -- normal LEDs for "Rudolf"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasRudolfIntro[ 5u ] = 
+CODE const U8 gau8RudolfIntro[] = 
 {
-  {40u, {0,   0,  0,  0,   0,  0,  0,   0,  0,  0,  0,  0}, LOAD,  0u },
-  {40u, {0,   0,  0,  1,   1,  1,  1,   1,  1,  0,  0,  0}, ADD | REPEAT,  14u },
-  {40u, {1,   1,  1, -1,  -1, -1, -1,  -1, -1,  1,  1,  1}, ADD | REPEAT,  14u },
-  {40u, {-1, -1, -1,  0,   0,  0,  0,   0,  0, -1, -1, -1}, ADD | REPEAT,  14u },
-  {40u, {0,   0,  0,  0,   0,  0,  0,   0,  0,  0,  0,  0}, ADD | REPEAT,  14u } // wait for nose
+  DELTA_LEDS( 40u, PATCH(  0,  0 ) ),
+  EXEC_LEDS( 40u, (0,   0,  0,  1,   1,  1,  1,   1,  1,  0,  0,  0), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 40u, (1,   1,  1, -1,  -1, -1, -1,  -1, -1,  1,  1,  1), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 40u, (-1, -1, -1,  0,   0,  0,  0,   0,  0, -1, -1, -1), ADD | REPEAT, 14u ),
+  EXEC_LEDS( 40u, (0,   0,  0,  0,   0,  0,  0,   0,  0,  0,  0,  0), ADD | REPEAT, 14u ) // wait for nose
 };
 //! \brief RudolfIntroRGB -- RGB LEDs for "Rudolf"
-CODE const S_ANIMATION_INSTRUCTION_RGB gasRudolfIntro_RGB[ 5u ] = 
+CODE const U8 gau8RudolfIntro_RGB[] = 
 {
-  { 40u, { 0,  0,  0}, LOAD, 0u },
-  { 40u, { 0,  0,  0}, ADD | REPEAT, 14u }, // wait for antlers
-  { 40u, { 0,  0,  0}, ADD | REPEAT, 14u }, // wait for head  
-  { 40u,   { 1,  1,  1}, ADD | REPEAT, 14u },
-  { 40u,   {-1, -1, -1}, ADD | REPEAT, 14u }
+  LOAD_RGB( 40u, ( 0,  0,  0) ),
+  EXEC_RGB( 40u, ( 0,  0,  0), ADD | REPEAT, 14u ), // wait for antlers
+  EXEC_RGB( 40u, ( 0,  0,  0), ADD | REPEAT, 14u ), // wait for head
+  EXEC_RGB( 40u,   ( 1,  1,  1), ADD | REPEAT, 14u ),
+  EXEC_RGB( 40u,   (-1, -1, -1), ADD | REPEAT, 14u )
 };
 
 //--------------------------------------------------------
 //! \brief KITT animation for "Rudolf" -- normal LEDs
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasKITT_rudolf[ 22u ] = 
-{
-  {200u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, LOAD,  0u },
-  {100u, {10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10}, LOAD,  0u },
-  {100u, {15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15}, LOAD,  0u },
-  {100u, {10, 15, 10,  0,  0,  5,  5,  0,  0, 10, 15, 10}, LOAD,  0u },
-  {100u, { 5, 10, 15,  0,  5, 10, 10,  5,  0, 15, 10,  5}, LOAD,  0u },
-  {100u, { 0,  5, 10,  5, 10, 15, 15, 10,  5, 10,  5,  0}, LOAD,  0u },
-  {100u, { 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0, 15, 10,  5,  5, 10, 15,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0, 10,  5,  0,  0,  5, 10,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  5,  0,  0,  0,  0,  5,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0,  5,  0,  0,  0,  0,  5,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0, 10,  5,  0,  0,  5, 10,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  0, 15, 10,  5,  5, 10, 15,  0,  0,  0}, LOAD,  0u },
-  {100u, { 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0}, LOAD,  0u },
-  {100u, { 0,  5, 10,  5, 10, 15, 15, 10,  5, 10,  5,  0}, LOAD,  0u },
-  {100u, { 5, 10, 15,  0,  5, 10, 10,  5,  0, 15, 10,  5}, LOAD,  0u },
-  {100u, {10, 15, 10,  0,  0,  5,  5,  0,  0, 10, 15, 10}, LOAD,  0u },
-  {100u, {15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15}, LOAD,  0u },
-  {100u, {10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10}, LOAD,  0u },
-  {100u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, LOAD,  0u }
+CODE const U8 gau8KITT_rudolf[] = 
+{
+  DELTA_LEDS( 200u, PATCH(  0,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  0,  5 ), PATCH( 11,  5 ) ),
+  DELTA_LEDS( 100u, PATCH(  0, 10 ), PATCH(  1,  5 ), PATCH( 10,  5 ), PATCH( 11, 10 ) ),
+  LOAD_LEDS( 100u, (15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15) ),
+  LOAD_LEDS( 100u, (10, 15, 10,  0,  0,  5,  5,  0,  0, 10, 15, 10) ),
+  LOAD_LEDS( 100u, ( 5, 10, 15,  0,  5, 10, 10,  5,  0, 15, 10,  5) ),
+  LOAD_LEDS( 100u, ( 0,  5, 10,  5, 10, 15, 15, 10,  5, 10,  5,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  0, 15, 10,  5,  5, 10, 15,  0,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  0, 10,  5,  0,  0,  5, 10,  0,  0,  0) ),
+  DELTA_LEDS( 100u, PATCH(  3,  5 ), PATCH(  4,  0 ), PATCH(  7,  0 ), PATCH(  8,  5 ) ),
+  DELTA_LEDS( 100u, PATCH(  3,  0 ), PATCH(  8,  0 ) ),
+  DELTA_LEDS( 100u, PATCH(  3,  5 ), PATCH(  8,  5 ) ),
+  DELTA_LEDS( 100u, PATCH(  3, 10 ), PATCH(  4,  5 ), PATCH(  7,  5 ), PATCH(  8, 10 ) ),
+  LOAD_LEDS( 100u, ( 0,  0,  0, 15, 10,  5,  5, 10, 15,  0,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  0,  5, 10, 15, 10, 10, 15, 10,  5,  0,  0) ),
+  LOAD_LEDS( 100u, ( 0,  5, 10,  5, 10, 15, 15, 10,  5, 10,  5,  0) ),
+  LOAD_LEDS( 100u, ( 5, 10, 15,  0,  5, 10, 10,  5,  0, 15, 10,  5) ),
+  LOAD_LEDS( 100u, (10, 15, 10,  0,  0,  5,  5,  0,  0, 10, 15, 10) ),
+  LOAD_LEDS( 100u, (15, 10,  5,  0,  0,  0,  0,  0,  0,  5, 10, 15) ),
+  LOAD_LEDS( 100u, (10,  5,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10) ),
+  DELTA_LEDS( 100u, PATCH(  0,  5 ), PATCH(  1,  0 ), PATCH( 10,  0 ), PATCH( 11,  5 ) )
   
 };
 
 //--------------------------------------------------------
 //! \brief GamerBlinkingRudolf -- normal LEDs for "Rudolf"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasGamerBlinkingRudolf[ 8u ] = 
+CODE const U8 gau8GamerBlinkingRudolf[] = 
 {
-  {2240u, {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD,  0u },
-  {200u,  {15, 15, 15,  0,  0,  0,  0,  0,  0, 15, 15, 15}, LOAD,  0u },
-  {200u,  {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD,  0u },
-  {200u,  {15, 15, 15,  0,  0,  0,  0,  0,  0, 15, 15, 15}, LOAD,  0u },
-  {200u,  {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD,  0u },
-  {200u,  { 0,  0,  0, 15, 15, 15, 15, 15, 15,  0,  0,  0}, LOAD,  0u },
-  {200u,  {15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15}, LOAD,  0u },
-  {200u,  { 0,  0,  0, 15, 15, 15, 15, 15, 15,  0,  0,  0}, LOAD,  0u }
+  LOAD_LEDS( 2240u, (15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15) ),
+  LOOP( 2u ),
+    LOAD_LEDS( 200u,  (15, 15, 15,  0,  0,  0,  0,  0,  0, 15, 15, 15) ),
+    LOAD_LEDS( 200u,  (15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15) ),
+  END_LOOP(),
+  LOAD_LEDS( 200u,  ( 0,  0,  0, 15, 15, 15, 15, 15, 15,  0,  0,  0) ),
+  LOAD_LEDS( 200u,  (15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15) ),
+  LOAD_LEDS( 200u,  ( 0,  0,  0, 15, 15, 15, 15, 15, 15,  0,  0,  0) )
 };
 //! \brief GamerBlinkingRudolfRGB -- RGB LEDs for "Rudolf"
-CODE const S_ANIMATION_INSTRUCTION_RGB gasGamerBlinkingRudolfRGB[ 7u ] = 
+CODE const U8 gau8GamerBlinkingRudolfRGB[] = 
 {
-  { 40u, { 15, 0,  0}, LOAD, 0u }, // Red, then smooth transition between colours
-  { 40u, { 0,  1,  0}, ADD | REPEAT, 14u }, // Yellow
-  { 40u, { -1, 0,  0}, ADD | REPEAT, 14u }, // Green
-  { 40u, { 0,  0,  1}, ADD | REPEAT, 14u }, // Cyan
-  { 40u, { 0, -1,  0}, ADD | REPEAT, 14u }, // Blue
-  { 40u, { 1,  0,  0}, ADD | REPEAT, 14u }, // Magenta
-  { 40u, { 0,  0, -1}, ADD | REPEAT, 14u }  // Red
+  LOAD_RGB( 40u, ( 15, 0,  0) ), // Red, then smooth transition between colours
+  EXEC_RGB( 40u, ( 0,  1,  0), ADD | REPEAT, 14u ), // Yellow
+  EXEC_RGB( 40u, ( -1, 0,  0), ADD | REPEAT, 14u ), // Green
+  EXEC_RGB( 40u, ( 0,  0,  1), ADD | REPEAT, 14u ), // Cyan
+  EXEC_RGB( 40u, ( 0, -1,  0), ADD | REPEAT, 14u ), // Blue
+  EXEC_RGB( 40u, ( 1,  0,  0), ADD | REPEAT, 14u ), // Magenta
+  EXEC_RGB( 40u, ( 0,  0, -1), ADD | REPEAT, 14u ) // Red
 };
 
 //--------------------------------------------------------
-//! \brief gasSnakeRudolf -- normal LEDs for "Rudolf" (YingYang animation replacement)
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasSnakeRudolf[ 14u ] = 
-{
-  {150u, { 0,  5, 10,  0,  0, 15,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  5,  0,  0, 10, 15,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  0,  0,  5, 10,  0, 15,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  0,  0,  0,  5, 15, 10,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  0, 15,  0,  0, 10,  5,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0, 15, 10,  0,  0,  5,  0,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0, 10,  5, 15,  0,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  5,  0, 10, 15,  0,  0,  0,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  0,  0,  5, 10,  0,  0, 15,  0,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  0,  0,  0,  5,  0,  0, 10, 15,  0}, LOAD,            0u },
-  {150u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10, 15}, LOAD,            0u },
-  {150u, {15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5, 10}, LOAD,            0u },
-  {150u, {10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, LOAD,            0u },
-  {150u, { 5, 10, 15,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD,            0u }
-};
-//! \brief gasSnakeRudolfRGB
-CODE const S_ANIMATION_INSTRUCTION_RGB gasSnakeRudolfRGB[ 4u ] = 
-{
-  { 525u, {15,  0,  0}, LOAD,     0u },
-  { 525u, {15, 15, 15}, LOAD,     0u },
-  { 525u, { 0, 15,  0}, LOAD,     0u },
-  { 525u, {15,  0, 15}, LOAD,     0u }
+//! \brief gau8SnakeRudolf -- normal LEDs for "Rudolf" (YingYang animation replacement)
+CODE const U8 gau8SnakeRudolf[] = 
+{
+  DELTA_LEDS( 150u, PATCH(  1,  5 ), PATCH(  2, 10 ), PATCH(  5, 15 ) ),
+  DELTA_LEDS( 150u, PATCH(  1,  0 ), PATCH(  2,  5 ), PATCH(  5, 10 ), PATCH(  6, 15 ) ),
+  DELTA_LEDS( 150u, PATCH(  2,  0 ), PATCH(  5,  5 ), PATCH(  6, 10 ), PATCH(  8, 15 ) ),
+  DELTA_LEDS( 150u, PATCH(  5,  0 ), PATCH(  6,  5 ), PATCH(  7, 15 ), PATCH(  8, 10 ) ),
+  DELTA_LEDS( 150u, PATCH(  4, 15 ), PATCH(  6,  0 ), PATCH(  7, 10 ), PATCH(  8,  5 ) ),
+  DELTA_LEDS( 150u, PATCH(  3, 15 ), PATCH(  4, 10 ), PATCH(  7,  5 ), PATCH(  8,  0 ) ),
+  DELTA_LEDS( 150u, PATCH(  3, 10 ), PATCH(  4,  5 ), PATCH(  5, 15 ), PATCH(  7,  0 ) ),
+  DELTA_LEDS( 150u, PATCH(  3,  5 ), PATCH(  4,  0 ), PATCH(  5, 10 ), PATCH(  6, 15 ) ),
+  DELTA_LEDS( 150u, PATCH(  3,  0 ), PATCH(  5,  5 ), PATCH(  6, 10 ), PATCH(  9, 15 ) ),
+  DELTA_LEDS( 150u, PATCH(  5,  0 ), PATCH(  6,  5 ), PATCH(  9, 10 ), PATCH( 10, 15 ) ),
+  DELTA_LEDS( 150u, PATCH(  6,  0 ), PATCH(  9,  5 ), PATCH( 10, 10 ), PATCH( 11, 15 ) ),
+  DELTA_LEDS( 150u, PATCH(  0, 15 ), PATCH(  9,  0 ), PATCH( 10,  5 ), PATCH( 11, 10 ) ),
+  DELTA_LEDS( 150u, PATCH(  0, 10 ), PATCH(  1, 15 ), PATCH( 10,  0 ), PATCH( 11,  5 ) ),
+  DELTA_LEDS( 150u, PATCH(  0,  5 ), PATCH(  1, 10 ), PATCH(  2, 15 ), PATCH( 11,  0 ) )
+};
+//! \brief gau8SnakeRudolfRGB
+CODE const U8 gau8SnakeRudolfRGB[] = 
+{
+  LOAD_RGB( 525u, (15,  0,  0) ),
+  LOAD_RGB( 525u, (15, 15, 15) ),
+  LOAD_RGB( 525u, ( 0, 15,  0) ),
+  LOAD_RGB( 525u, (15,  0, 15) )
 };
 
 //--------------------------------------------------------
 //! \brief IceRudolf -- normal LEDs for "Rudolf"
-CODE const S_ANIMATION_INSTRUCTION_NORMAL gasIceRudolf[ 7u ] = 
+CODE const U8 gau8IceRudolf[] = 
 {
-  {300u, { 0,  0,  0,  0,  0, 15, 15,  0,  0,  0,  0,  0}, LOAD, 0u },
-  {300u, { 0,  0, 15,  0, 15, 10, 10, 15,  0, 15,  0,  0}, LOAD, 0u },
-  {300u, { 0, 15, 10, 15, 10,  5,  5, 10, 15, 10, 15,  0}, LOAD, 0u },
-  {300u, {15, 10,  5, 10,  5,  0,  0,  5, 10,  5, 10, 15}, LOAD, 0u },
-  {300u, {10,  5,  0,  5,  0,  0,  0,  0,  5,  0,  5, 10}, LOAD, 0u },
-  {300u, { 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5}, LOAD, 0u },
-  {300u, { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, LOAD, 0u }
+  DELTA_LEDS( 300u, PATCH(  5, 15 ), PATCH(  6, 15 ) ),
+  LOAD_LEDS( 300u, ( 0,  0, 15,  0, 15, 10, 10, 15,  0, 15,  0,  0) ),
+  LOAD_LEDS( 300u, ( 0, 15, 10, 15, 10,  5,  5, 10, 15, 10, 15,  0) ),
+  LOAD_LEDS( 300u, (15, 10,  5, 10,  5,  0,  0,  5, 10,  5, 10, 15) ),
+  LOAD_LEDS( 300u, (10,  5,  0,  5,  0,  0,  0,  0,  5,  0,  5, 10) ),
+  LOAD_LEDS( 300u, ( 5,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5) ),
+  DELTA_LEDS( 300u, PATCH(  0,  0 ), PATCH( 11,  0 ) )
 };
 //! \brief IceRudolfRGB
-CODE const S_ANIMATION_INSTRUCTION_RGB gasIceRudolfRGB[ 4u ] = 
+CODE const U8 gau8IceRudolfRGB[] = 
 {
-  { 150u, { 0, 15, 15}, LOAD,          0u },
-  {  60u, { 0, -1,  0}, ADD | REPEAT, 14u },
-  { 150u, { 0,  0, 15}, LOAD,          0u },
-  {  60u, { 0,  1,  0}, ADD | REPEAT, 14u },
+  LOAD_RGB( 150u, ( 0, 15, 15) ),
+  FADE_RGB( 900u, ( 0,  0, 15), EASE_LINEAR ),
+  LOAD_RGB( 150u, ( 0,  0, 15) ),
+  FADE_RGB( 900u, ( 0, 15, 15), EASE_LINEAR ),
 };
 
 // *******************************************************
@@ -1154,28 +1390,37 @@ CODE const S_ANIMATION_INSTRUCTION_RGB gasIceRudolfRGB[ 4u ] =
 //! \brief Table of animations
 CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] = 
 {
-  {sizeof(gasRetroVersion)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasRetroVersion,     sizeof(gasRetroVersionRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasRetroVersionRGB },
-  {sizeof(gasSoftFlashing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasSoftFlashing,     sizeof(gasSoftFlashingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasSoftFlashingRGB },
-  //  {sizeof(gasShootingStar)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasShootingStar,     sizeof(gasShootingStarRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasShootingStarRGB },
-  {sizeof(gasDisco)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),            gasDisco,            sizeof(gasDiscoRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),            gasDiscoRGB },
-  {sizeof(gasStarLaunch)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasStarLaunch,       sizeof(gasStarLaunchRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),       gasStarLaunchRGB },
-  {sizeof(gasCrissCross)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasCrissCross,       sizeof(gasCrissCrossRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),       gasCrissCrossRGB },
-  {sizeof(gasGenericFlasher)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),   gasGenericFlasher,   sizeof(gasGenericFlasherRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),   gasGenericFlasherRGB },
-  {sizeof(gasKITT)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),             gasKITT,             sizeof(gasKITTRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),             gasKITTRGB },
-  {sizeof(gasPingpong)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasPingpong,         sizeof(gasPingpongRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasPingpongRGB },
-  {sizeof(gasFadeRing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasFadeRing,         sizeof(gasFadeRingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasFadeRingRGB },
-  {sizeof(gasYingYang)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasYingYang,         sizeof(gasYingYangRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasYingYangRGB },
-  {sizeof(gasPseudoRandomFade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL), gasPseudoRandomFade, sizeof(gasPseudoRandomFadeRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasPseudoRandomFadeRGB },
-  //  {sizeof(gasFadeout)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasFadeout,          sizeof(gasFadeoutRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasFadeoutRGB },
-  {sizeof(gasFlicker)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasFlicker,          sizeof(gasFlickerRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasFlickerRGB },
-  {sizeof(gasRace)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),             gasRace,             sizeof(gasRaceRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),             gasRaceRGB },
-  {sizeof(gasSparkle)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasSparkle,          sizeof(gasSparkleRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasSparkleRGB },
-  {sizeof(gasIce)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),              gasIce,              sizeof(gasIceRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),              gasIceRGB },
-  {sizeof(gasSplit2)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasSplit2,           sizeof(gasSplit2RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),           gasSplit2RGB },
-  //  {sizeof(gasSplit3fade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasSplit3fade,       sizeof(gasSplit3fadeRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),       gasSplit3fadeRGB },
-  {sizeof(gasStepping)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasStepping,         sizeof(gasSteppingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasSteppingRGB },
+  {sizeof(gau8RetroVersion),     gau8RetroVersion,     sizeof(gau8RetroVersionRGB),     gau8RetroVersionRGB },
+  {sizeof(gau8SoftFlashing),     gau8SoftFlashing,     sizeof(gau8SoftFlashingRGB),     gau8SoftFlashingRGB },
+  //  {sizeof(gau8ShootingStar),     gau8ShootingStar,     sizeof(gau8ShootingStarRGB),     gau8ShootingStarRGB },
+  {sizeof(gau8Disco),            gau8Disco,            sizeof(gau8DiscoRGB),            gau8DiscoRGB },
+  {sizeof(gau8StarLaunch),       gau8StarLaunch,       sizeof(gau8StarLaunchRGB),       gau8StarLaunchRGB },
+  {sizeof(gau8CrissCross),       gau8CrissCross,       sizeof(gau8CrissCrossRGB),       gau8CrissCrossRGB },
+  {sizeof(gau8GenericFlasher),   gau8GenericFlasher,   sizeof(gau8GenericFlasherRGB),   gau8GenericFlasherRGB },
+  {sizeof(gau8KITT),             gau8KITT,             sizeof(gau8KITTRGB),             gau8KITTRGB },
+  {sizeof(gau8Pingpong),         gau8Pingpong,         sizeof(gau8PingpongRGB),         gau8PingpongRGB },
+  {sizeof(gau8FadeRing),         gau8FadeRing,         sizeof(gau8FadeRingRGB),         gau8FadeRingRGB },
+  {sizeof(gau8YingYang),         gau8YingYang,         sizeof(gau8YingYangRGB),         gau8YingYangRGB },
+  {sizeof(gau8PseudoRandomFade), gau8PseudoRandomFade, sizeof(gau8PseudoRandomFadeRGB), gau8PseudoRandomFadeRGB },
+  //  {sizeof(gau8Fadeout),          gau8Fadeout,          sizeof(gau8FadeoutRGB),          gau8FadeoutRGB },
+  {sizeof(gau8Flicker),          gau8Flicker,          sizeof(gau8FlickerRGB),          gau8FlickerRGB },
+  {sizeof(gau8Race),             gau8Race,             sizeof(gau8RaceRGB),             gau8RaceRGB },
+  {sizeof(gau8Sparkle),          gau8Sparkle,          sizeof(gau8SparkleRGB),          gau8SparkleRGB },
+  {sizeof(gau8Ice),              gau8Ice,              sizeof(gau8IceRGB),              gau8IceRGB },
+  {sizeof(gau8Split2),           gau8Split2,           sizeof(gau8Split2RGB),           gau8Split2RGB },
+  //  {sizeof(gau8Split3fade),       gau8Split3fade,       sizeof(gau8Split3fadeRGB),       gau8Split3fadeRGB },
+  {sizeof(gau8Stepping),         gau8Stepping,         sizeof(gau8SteppingRGB),         gau8SteppingRGB },
   // Last animation, don't change its location
-  {sizeof(gasBlackness)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasBlackness,        sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB }
+  {sizeof(gau8Blackness),        gau8Blackness,        sizeof(gau8BlacknessRGB),        gau8BlacknessRGB }
+};
+
+//! \brief Table of subroutines, indexed by E_ANIMATION_SUBROUTINE
+CODE const S_ANIMATION_SUBROUTINE gasSubroutines[ NUM_SUBROUTINES ] = 
+{
+  {sizeof(gau8ShootingStar),          gau8ShootingStar },
+  {sizeof(gau8ShootingStarRGB),       gau8ShootingStarRGB },
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
 };
 #endif
 
@@ -1183,38 +1428,47 @@ CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] =
 //! \brief Table of animations
 CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] = 
 {
-  {sizeof(gasRetroVersion)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasRetroVersion,     sizeof(gasRetroVersionRGB_yellow)/sizeof(S_ANIMATION_INSTRUCTION_RGB),  gasRetroVersionRGB_yellow },
-  {sizeof(gasSoftFlashing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasSoftFlashing,     sizeof(gasSoftFlashingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasSoftFlashingRGB },
-  //  {sizeof(gasShootingStar)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasShootingStar,     sizeof(gasShootingStarRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasShootingStarRGB },
-  {sizeof(gasDisco)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),            gasDisco,            sizeof(gasDiscoRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),            gasDiscoRGB },
-  {sizeof(gasStarLaunch)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasStarLaunch,       sizeof(gasStarLaunchRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),       gasStarLaunchRGB },
-  {sizeof(gasCrissCross)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasCrissCross,       sizeof(gasCrissCrossRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),       gasCrissCrossRGB },
-  {sizeof(gasGenericFlasher)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),   gasGenericFlasher,   sizeof(gasGenericFlasherRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),   gasGenericFlasherRGB },
-  {sizeof(gasKITT)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),             gasKITT,             sizeof(gasKITTRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),             gasKITTRGB },
-  {sizeof(gasPingpong)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasPingpong,         sizeof(gasPingpongRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasPingpongRGB },
-  {sizeof(gasFadeRing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasFadeRing,         sizeof(gasFadeRingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasFadeRingRGB },
-  {sizeof(gasYingYang)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasYingYang,         sizeof(gasYingYangRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasYingYangRGB },
-  {sizeof(gasPseudoRandomFade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL), gasPseudoRandomFade, sizeof(gasPseudoRandomFadeRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasPseudoRandomFadeRGB },
-  //  {sizeof(gasFadeout)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasFadeout,          sizeof(gasFadeoutRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasFadeoutRGB },
-  {sizeof(gasFlicker)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasFlicker,          sizeof(gasFlickerRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasFlickerRGB },
-  {sizeof(gasRace)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),             gasRace,             sizeof(gasRaceRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),             gasRaceRGB },
-  {sizeof(gasSparkle)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasSparkle,          sizeof(gasSparkleRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasSparkleRGB },
-  {sizeof(gasIce)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),              gasIce,              sizeof(gasIceRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),              gasIceRGB },
-  {sizeof(gasSplit2)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasSplit2,           sizeof(gasSplit2RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),           gasSplit2RGB },
-  //  {sizeof(gasSplit3fade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasSplit3fade,       sizeof(gasSplit3fadeRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),       gasSplit3fadeRGB },
-  {sizeof(gasStepping)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasStepping,         sizeof(gasSteppingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasSteppingRGB },
+  {sizeof(gau8RetroVersion),     gau8RetroVersion,     sizeof(gau8RetroVersionRGB_yellow),  gau8RetroVersionRGB_yellow },
+  {sizeof(gau8SoftFlashing),     gau8SoftFlashing,     sizeof(gau8SoftFlashingRGB),     gau8SoftFlashingRGB },
+  //  {sizeof(gau8ShootingStar),     gau8ShootingStar,     sizeof(gau8ShootingStarRGB),     gau8ShootingStarRGB },
+  {sizeof(gau8Disco),            gau8Disco,            sizeof(gau8DiscoRGB),            gau8DiscoRGB },
+  {sizeof(gau8StarLaunch),       gau8StarLaunch,       sizeof(gau8StarLaunchRGB),       gau8StarLaunchRGB },
+  {sizeof(gau8CrissCross),       gau8CrissCross,       sizeof(gau8CrissCrossRGB),       gau8CrissCrossRGB },
+  {sizeof(gau8GenericFlasher),   gau8GenericFlasher,   sizeof(gau8GenericFlasherRGB),   gau8GenericFlasherRGB },
+  {sizeof(gau8KITT),             gau8KITT,             sizeof(gau8KITTRGB),             gau8KITTRGB },
+  {sizeof(gau8Pingpong),         gau8Pingpong,         sizeof(gau8PingpongRGB),         gau8PingpongRGB },
+  {sizeof(gau8FadeRing),         gau8FadeRing,         sizeof(gau8FadeRingRGB),         gau8FadeRingRGB },
+  {sizeof(gau8YingYang),         gau8YingYang,         sizeof(gau8YingYangRGB),         gau8YingYangRGB },
+  {sizeof(gau8PseudoRandomFade), gau8PseudoRandomFade, sizeof(gau8PseudoRandomFadeRGB), gau8PseudoRandomFadeRGB },
+  //  {sizeof(gau8Fadeout),          gau8Fadeout,          sizeof(gau8FadeoutRGB),          gau8FadeoutRGB },
+  {sizeof(gau8Flicker),          gau8Flicker,          sizeof(gau8FlickerRGB),          gau8FlickerRGB },
+  {sizeof(gau8Race),             gau8Race,             sizeof(gau8RaceRGB),             gau8RaceRGB },
+  {sizeof(gau8Sparkle),          gau8Sparkle,          sizeof(gau8SparkleRGB),          gau8SparkleRGB },
+  {sizeof(gau8Ice),              gau8Ice,              sizeof(gau8IceRGB),              gau8IceRGB },
+  {sizeof(gau8Split2),           gau8Split2,           sizeof(gau8Split2RGB),           gau8Split2RGB },
+  //  {sizeof(gau8Split3fade),       gau8Split3fade,       sizeof(gau8Split3fadeRGB),       gau8Split3fadeRGB },
+  {sizeof(gau8Stepping),         gau8Stepping,         sizeof(gau8SteppingRGB),         gau8SteppingRGB },
 /*
   // NEW, TO BE TESTED
-  {sizeof(gasStepping_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasStepping_hopehely, sizeof(gasStepping_hopehely_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasStepping_hopehely_RGB}, 
-  {sizeof(gasStepping_hoember)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasStepping_hoember, sizeof(gasStepping_hoember_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasStepping_hoember_RGB}, 
-  {sizeof(gasStepping_mezi)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasStepping_mezi, sizeof(gasStepping_mezi_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasStepping_mezi_RGB}, 
-  {sizeof(gasSplit2_fade_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasSplit2_fade_hopehely, sizeof(gasSplit2_fade_hopehely_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasSplit2_fade_hopehely_RGB}, 
-  {sizeof(gasSplit2_fade_ease_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasSplit2_fade_ease_hopehely, sizeof(gasSplit2_fade_ease_hopehely_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasSplit2_fade_ease_hopehely_RGB}, 
-  {sizeof(gasSplit2_mezi)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasSplit2_mezi, sizeof(gasSplit2_mezi_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasSplit2_mezi_RGB}, 
-  {sizeof(gasFlasherNoEyes_mezi)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasFlasherNoEyes_mezi, sizeof(gasFlasherNoEyes_mezi_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasFlasherNoEyes_mezi_RGB}, 
+  {sizeof(gau8Stepping_hopehely),gau8Stepping_hopehely, sizeof(gau8Stepping_hopehely_RGB), gau8Stepping_hopehely_RGB}, 
+  {sizeof(gau8Stepping_hoember),gau8Stepping_hoember, sizeof(gau8Stepping_hoember_RGB), gau8Stepping_hoember_RGB}, 
+  {sizeof(gau8Stepping_mezi),gau8Stepping_mezi, sizeof(gau8Stepping_mezi_RGB), gau8Stepping_mezi_RGB}, 
+  {sizeof(gau8Split2_fade_hopehely),gau8Split2_fade_hopehely, sizeof(gau8Split2_fade_hopehely_RGB), gau8Split2_fade_hopehely_RGB}, 
+  {sizeof(gau8Split2_fade_ease_hopehely),gau8Split2_fade_ease_hopehely, sizeof(gau8Split2_fade_ease_hopehely_RGB), gau8Split2_fade_ease_hopehely_RGB}, 
+  {sizeof(gau8Split2_mezi),gau8Split2_mezi, sizeof(gau8Split2_mezi_RGB), gau8Split2_mezi_RGB}, 
+  {sizeof(gau8FlasherNoEyes_mezi),gau8FlasherNoEyes_mezi, sizeof(gau8FlasherNoEyes_mezi_RGB), gau8FlasherNoEyes_mezi_RGB}, 
   */
   // Last animation, don't change its location
-  {sizeof(gasBlackness)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasBlackness,        sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB }
+  {sizeof(gau8Blackness),        gau8Blackness,        sizeof(gau8BlacknessRGB),        gau8BlacknessRGB }
+};
+
+//! \brief Table of subroutines, indexed by E_ANIMATION_SUBROUTINE
+CODE const S_ANIMATION_SUBROUTINE gasSubroutines[ NUM_SUBROUTINES ] = 
+{
+  {sizeof(gau8ShootingStar),          gau8ShootingStar },
+  {sizeof(gau8ShootingStarRGB),       gau8ShootingStarRGB },
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // gau8Buttons_mezi[] if gau8Stepping_mezi[] is enabled
 };
 #endif
 
@@ -1222,25 +1476,34 @@ CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] =
 //! \brief Table of animations
 CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] = 
 {
-  {sizeof(gasRetroVersion)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasRetroVersion,     sizeof(gasRetroVersionRGB_yellow)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasRetroVersionRGB_yellow },
-  {sizeof(gasSoftFlashing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasSoftFlashing,     sizeof(gasSoftFlashingRGB_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasSoftFlashingRGB_hopehely },
-  {sizeof(gasShootingStar_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),  gasShootingStar_hopehely,     sizeof(gasShootingStar_hopehely_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasShootingStar_hopehely_RGB },
-  {sizeof(gasSplit2_fade_ease_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasSplit2_fade_ease_hopehely, sizeof(gasSplit2_fade_ease_hopehely_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasSplit2_fade_ease_hopehely_RGB}, 
-  {sizeof(gasGenericFlasher)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),   gasGenericFlasher,   sizeof(gasGenericFlasherRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),   gasGenericFlasherRGB },
-  {sizeof(gasKITT_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),    gasKITT_hopehely,    sizeof(gasKITT_hopehely_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),   gasKITT_hopehely_RGB },
-  {sizeof(gasDisco)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),            gasDisco,            sizeof(gasDiscoRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),            gasDiscoRGB },
-  {sizeof(gasFadeRing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasFadeRing,         sizeof(gasFadeRingRGB_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_RGB),  gasFadeRingRGB_hopehely },
-  {sizeof(gasYingYang)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasYingYang,         sizeof(gasYingYangRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasYingYangRGB },
-  {sizeof(gasPseudoRandomFade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL), gasPseudoRandomFade, sizeof(gasPseudoRandomFadeRGB_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasPseudoRandomFadeRGB_hopehely },
-//  {sizeof(gasFadeout)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasFadeout,          sizeof(gasFadeoutRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasFadeoutRGB },
-//  {sizeof(gasFlicker)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasFlicker,          sizeof(gasFlickerRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasFlickerRGB },
-  {sizeof(gasRace_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),    gasRace_hopehely,             sizeof(gasRaceRGB_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_RGB),  gasRaceRGB_hopehely },
-  {sizeof(gasSparkle)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasSparkle,          sizeof(gasSparkleRGB_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_RGB),  gasSparkleRGB_hopehely },
-  {sizeof(gasIce_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasIce_hopehely,              sizeof(gasIceRGB_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_RGB),  gasIceRGB_hopehely },
-  {sizeof(gasSplit2_fade_hopehely)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasSplit2_fade_hopehely, sizeof(gasSplit2_fade_hopehely_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasSplit2_fade_hopehely_RGB}, 
-  {sizeof(gasStepping)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasStepping,         sizeof(gasSteppingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasSteppingRGB },
+  {sizeof(gau8RetroVersion),     gau8RetroVersion,     sizeof(gau8RetroVersionRGB_yellow),     gau8RetroVersionRGB_yellow },
+  {sizeof(gau8SoftFlashing),     gau8SoftFlashing,     sizeof(gau8SoftFlashingRGB_hopehely),     gau8SoftFlashingRGB_hopehely },
+  {sizeof(gau8ShootingStar_hopehely),  gau8ShootingStar_hopehely,     sizeof(gau8ShootingStar_hopehely_RGB),     gau8ShootingStar_hopehely_RGB },
+  {sizeof(gau8Split2_fade_ease_hopehely),gau8Split2_fade_ease_hopehely, sizeof(gau8Split2_fade_ease_hopehely_RGB), gau8Split2_fade_ease_hopehely_RGB}, 
+  {sizeof(gau8GenericFlasher),   gau8GenericFlasher,   sizeof(gau8GenericFlasherRGB),   gau8GenericFlasherRGB },
+  {sizeof(gau8KITT_hopehely),    gau8KITT_hopehely,    sizeof(gau8KITT_hopehely_RGB),   gau8KITT_hopehely_RGB },
+  {sizeof(gau8Disco),            gau8Disco,            sizeof(gau8DiscoRGB),            gau8DiscoRGB },
+  {sizeof(gau8FadeRing),         gau8FadeRing,         sizeof(gau8FadeRingRGB_hopehely),  gau8FadeRingRGB_hopehely },
+  {sizeof(gau8YingYang),         gau8YingYang,         sizeof(gau8YingYangRGB),         gau8YingYangRGB },
+  {sizeof(gau8PseudoRandomFade), gau8PseudoRandomFade, sizeof(gau8PseudoRandomFadeRGB_hopehely), gau8PseudoRandomFadeRGB_hopehely },
+//  {sizeof(gau8Fadeout),          gau8Fadeout,          sizeof(gau8FadeoutRGB),          gau8FadeoutRGB },
+//  {sizeof(gau8Flicker),          gau8Flicker,          sizeof(gau8FlickerRGB),          gau8FlickerRGB },
+  {sizeof(gau8Race_hopehely),    gau8Race_hopehely,             sizeof(gau8RaceRGB_hopehely),  gau8RaceRGB_hopehely },
+  {sizeof(gau8Sparkle),          gau8Sparkle,          sizeof(gau8SparkleRGB_hopehely),  gau8SparkleRGB_hopehely },
+  {sizeof(gau8Ice_hopehely),     gau8Ice_hopehely,              sizeof(gau8IceRGB_hopehely),  gau8IceRGB_hopehely },
+  {sizeof(gau8Split2_fade_hopehely),gau8Split2_fade_hopehely, sizeof(gau8Split2_fade_hopehely_RGB), gau8Split2_fade_hopehely_RGB}, 
+  {sizeof(gau8Stepping),         gau8Stepping,         sizeof(gau8SteppingRGB),         gau8SteppingRGB },
   // Last animation, don't change its location
-  {sizeof(gasBlackness)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasBlackness,        sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB }
+  {sizeof(gau8Blackness),        gau8Blackness,        sizeof(gau8BlacknessRGB),        gau8BlacknessRGB }
+};
+
+//! \brief Table of subroutines, indexed by E_ANIMATION_SUBROUTINE
+CODE const S_ANIMATION_SUBROUTINE gasSubroutines[ NUM_SUBROUTINES ] = 
+{
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
+  {sizeof(gau8ShootingStar_hopehely), gau8ShootingStar_hopehely },
+  {0u,                                NULL },                       // not used on this board
 };
 #endif
 
@@ -1248,18 +1511,27 @@ CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] =
 //! \brief Table of animations
 CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] = 
 {
-  {sizeof(gasRetroVersion)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasRetroVersion,     sizeof(gasRetroVersionRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasRetroVersionRGB },
-  {sizeof(gasSoftFlashing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasSoftFlashing,     sizeof(gasSoftFlashingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasSoftFlashingRGB },
-  {sizeof(gasDisco)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),               gasDisco,            sizeof(gasDiscoRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),            gasDiscoRGB },
-  {sizeof(gasFadeRing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),            gasFadeRing,         sizeof(gasFadeRingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasFadeRingRGB },
-  {sizeof(gasGenericFlasher)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),      gasGenericFlasher,   sizeof(gasGenericFlasherRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),   gasGenericFlasherRGB },
-  {sizeof(gasPseudoRandomFade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),    gasPseudoRandomFade, sizeof(gasPseudoRandomFadeRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasPseudoRandomFadeRGB },
-  {sizeof(gasStepping_mezi)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasStepping_mezi, sizeof(gasStepping_mezi_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasStepping_mezi_RGB}, 
-  {sizeof(gasSplit2_mezi)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasSplit2_mezi, sizeof(gasSplit2_mezi_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasSplit2_mezi_RGB}, 
-  {sizeof(gasSparkle)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),             gasSparkle,          sizeof(gasSparkleRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasSparkleRGB },
-  {sizeof(gasFlasherNoEyes_mezi)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),  gasFlasherNoEyes_mezi, sizeof(gasFlasherNoEyes_mezi_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB), gasFlasherNoEyes_mezi_RGB}, 
+  {sizeof(gau8RetroVersion),        gau8RetroVersion,     sizeof(gau8RetroVersionRGB),     gau8RetroVersionRGB },
+  {sizeof(gau8SoftFlashing),        gau8SoftFlashing,     sizeof(gau8SoftFlashingRGB),     gau8SoftFlashingRGB },
+  {sizeof(gau8Disco),               gau8Disco,            sizeof(gau8DiscoRGB),            gau8DiscoRGB },
+  {sizeof(gau8FadeRing),            gau8FadeRing,         sizeof(gau8FadeRingRGB),         gau8FadeRingRGB },
+  {sizeof(gau8GenericFlasher),      gau8GenericFlasher,   sizeof(gau8GenericFlasherRGB),   gau8GenericFlasherRGB },
+  {sizeof(gau8PseudoRandomFade),    gau8PseudoRandomFade, sizeof(gau8PseudoRandomFadeRGB), gau8PseudoRandomFadeRGB },
+  {sizeof(gau8Stepping_mezi),       gau8Stepping_mezi, sizeof(gau8Stepping_mezi_RGB), gau8Stepping_mezi_RGB}, 
+  {sizeof(gau8Split2_mezi),         gau8Split2_mezi, sizeof(gau8Split2_mezi_RGB), gau8Split2_mezi_RGB}, 
+  {sizeof(gau8Sparkle),             gau8Sparkle,          sizeof(gau8SparkleRGB),          gau8SparkleRGB },
+  {sizeof(gau8FlasherNoEyes_mezi),  gau8FlasherNoEyes_mezi, sizeof(gau8FlasherNoEyes_mezi_RGB), gau8FlasherNoEyes_mezi_RGB}, 
   // Last animation, don't change its location
-  {sizeof(gasBlackness)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasBlackness,        sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB }
+  {sizeof(gau8Blackness),           gau8Blackness,        sizeof(gau8BlacknessRGB),        gau8BlacknessRGB }
+};
+
+//! \brief Table of subroutines, indexed by E_ANIMATION_SUBROUTINE
+CODE const S_ANIMATION_SUBROUTINE gasSubroutines[ NUM_SUBROUTINES ] = 
+{
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
+  {sizeof(gau8Buttons_mezi),          gau8Buttons_mezi },
 };
 #endif
 
@@ -1267,22 +1539,31 @@ CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] =
 //! \brief Table of animations
 CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] = 
 {
-  {sizeof(gasRetroVersion)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasRetroVersion,      sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasSoftFlashing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasSoftFlashing,      sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasDisco)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),                  gasDisco,             sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasFadeRing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),               gasFadeRing,          sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasGenericFlasher)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasGenericFlasher,    sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasPseudoRandomFade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasPseudoRandomFade,  sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasAroundFill_ajandek)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasAroundFill_ajandek,sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasStepping_ajandek)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasStepping_ajandek,  sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasSplit2_ajandek)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasSplit2_ajandek,    sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasSparkle)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),                gasSparkle,           sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasOpenClose_ajandek)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),      gasOpenClose_ajandek, sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasYingYang)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),               gasYingYang,          sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasMasni)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),                  gasMasni,             sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
-  {sizeof(gasAround_ajandek)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),         gasAround_ajandek,    sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB },
+  {sizeof(gau8RetroVersion),           gau8RetroVersion,      sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8SoftFlashing),           gau8SoftFlashing,      sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8Disco),                  gau8Disco,             sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8FadeRing),               gau8FadeRing,          sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8GenericFlasher),         gau8GenericFlasher,    sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8PseudoRandomFade),       gau8PseudoRandomFade,  sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8AroundFill_ajandek),     gau8AroundFill_ajandek,sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8Stepping_ajandek),       gau8Stepping_ajandek,  sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8Split2_ajandek),         gau8Split2_ajandek,    sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8Sparkle),                gau8Sparkle,           sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8OpenClose_ajandek),      gau8OpenClose_ajandek, sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8YingYang),               gau8YingYang,          sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8Masni),                  gau8Masni,             sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
+  {sizeof(gau8Around_ajandek),         gau8Around_ajandek,    sizeof(gau8BlacknessRGB),        gau8BlacknessRGB },
   // Last animation, don't change its location
-  {sizeof(gasBlackness)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),              gasBlackness,         sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB }
+  {sizeof(gau8Blackness),              gau8Blackness,         sizeof(gau8BlacknessRGB),        gau8BlacknessRGB }
+};
+
+//! \brief Table of subroutines, indexed by E_ANIMATION_SUBROUTINE
+CODE const S_ANIMATION_SUBROUTINE gasSubroutines[ NUM_SUBROUTINES ] = 
+{
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
 };
 #endif
 
@@ -1290,43 +1571,104 @@ CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] =
 //! \brief Table of animations
 CODE const S_ANIMATION gasAnimations[ NUM_ANIMATIONS ] = 
 {
-  {sizeof(gasRudolfIntro)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasRudolfIntro,        sizeof(gasRudolfIntro_RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasRudolfIntro_RGB },
-  {sizeof(gasSoftFlashing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasSoftFlashing,       sizeof(gasSoftFlashingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasSoftFlashingRGB },
-  {sizeof(gasFlicker)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),            gasFlicker,            sizeof(gasFlickerRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),              gasFlickerRGB },
-  {sizeof(gasStarLaunch_rudolf)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),  gasStarLaunch_rudolf,  sizeof(gasStarLaunchRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),           gasStarLaunchRGB },
-  {sizeof(gasDisco_rudolf)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),       gasDisco_rudolf,       sizeof(gasDiscoRGB_rudolf)/sizeof(S_ANIMATION_INSTRUCTION_RGB),         gasDiscoRGB_rudolf },
-  {sizeof(gasGamerBlinkingRudolf)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),gasGamerBlinkingRudolf,sizeof(gasGamerBlinkingRudolfRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),  gasGamerBlinkingRudolfRGB },
-  {sizeof(gasGenericFlasher)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),     gasGenericFlasher,     sizeof(gasGenericFlasherRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),       gasGenericFlasherRGB },
-  {sizeof(gasKITT_rudolf)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasKITT_rudolf,        sizeof(gasKITTRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),                 gasKITTRGB },
-  {sizeof(gasPingpong)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasPingpong,           sizeof(gasPingpongRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),             gasPingpongRGB },
-  {sizeof(gasFadeRing)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasFadeRing,           sizeof(gasFadeRingRGB_rudolf)/sizeof(S_ANIMATION_INSTRUCTION_RGB),      gasFadeRingRGB_rudolf },
-  {sizeof(gasSnakeRudolf)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasSnakeRudolf,        sizeof(gasSnakeRudolfRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),          gasSnakeRudolfRGB },
-  {sizeof(gasStepping)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),           gasStepping,           sizeof(gasSteppingRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),             gasSteppingRGB },
-  {sizeof(gasSparkle)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),            gasSparkle,            sizeof(gasSparkleRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),              gasSparkleRGB },
-  {sizeof(gasRace)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),               gasRace,               sizeof(gasRaceRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),                 gasRaceRGB },
-  {sizeof(gasPseudoRandomFade)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),   gasPseudoRandomFade,   sizeof(gasPseudoRandomFadeRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),     gasPseudoRandomFadeRGB },
-  {sizeof(gasIceRudolf)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),          gasIceRudolf,          sizeof(gasIceRudolfRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),            gasIceRudolfRGB }, 
-  {sizeof(gasSplit2_rudolf)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),      gasSplit2_rudolf,      sizeof(gasSplit2RGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),               gasSplit2RGB },
+  {sizeof(gau8RudolfIntro),        gau8RudolfIntro,        sizeof(gau8RudolfIntro_RGB),         gau8RudolfIntro_RGB },
+  {sizeof(gau8SoftFlashing),       gau8SoftFlashing,       sizeof(gau8SoftFlashingRGB),         gau8SoftFlashingRGB },
+  {sizeof(gau8Flicker),            gau8Flicker,            sizeof(gau8FlickerRGB),              gau8FlickerRGB },
+  {sizeof(gau8StarLaunch_rudolf),  gau8StarLaunch_rudolf,  sizeof(gau8StarLaunchRGB),           gau8StarLaunchRGB },
+  {sizeof(gau8Disco_rudolf),       gau8Disco_rudolf,       sizeof(gau8DiscoRGB_rudolf),         gau8DiscoRGB_rudolf },
+  {sizeof(gau8GamerBlinkingRudolf),gau8GamerBlinkingRudolf,sizeof(gau8GamerBlinkingRudolfRGB),  gau8GamerBlinkingRudolfRGB },
+  {sizeof(gau8GenericFlasher),     gau8GenericFlasher,     sizeof(gau8GenericFlasherRGB),       gau8GenericFlasherRGB },
+  {sizeof(gau8KITT_rudolf),        gau8KITT_rudolf,        sizeof(gau8KITTRGB),                 gau8KITTRGB },
+  {sizeof(gau8Pingpong),           gau8Pingpong,           sizeof(gau8PingpongRGB),             gau8PingpongRGB },
+  {sizeof(gau8FadeRing),           gau8FadeRing,           sizeof(gau8FadeRingRGB_rudolf),      gau8FadeRingRGB_rudolf },
+  {sizeof(gau8SnakeRudolf),        gau8SnakeRudolf,        sizeof(gau8SnakeRudolfRGB),          gau8SnakeRudolfRGB },
+  {sizeof(gau8Stepping),           gau8Stepping,           sizeof(gau8SteppingRGB),             gau8SteppingRGB },
+  {sizeof(gau8Sparkle),            gau8Sparkle,            sizeof(gau8SparkleRGB),              gau8SparkleRGB },
+  {sizeof(gau8Race),               gau8Race,               sizeof(gau8RaceRGB),                 gau8RaceRGB },
+  {sizeof(gau8PseudoRandomFade),   gau8PseudoRandomFade,   sizeof(gau8PseudoRandomFadeRGB),     gau8PseudoRandomFadeRGB },
+  {sizeof(gau8IceRudolf),          gau8IceRudolf,          sizeof(gau8IceRudolfRGB),            gau8IceRudolfRGB }, 
+  {sizeof(gau8Split2_rudolf),      gau8Split2_rudolf,      sizeof(gau8Split2RGB),               gau8Split2RGB },
   
   // Last animation, don't change its location
-  {sizeof(gasBlackness)/sizeof(S_ANIMATION_INSTRUCTION_NORMAL),        gasBlackness,        sizeof(gasBlacknessRGB)/sizeof(S_ANIMATION_INSTRUCTION_RGB),        gasBlacknessRGB }
+  {sizeof(gau8Blackness),        gau8Blackness,        sizeof(gau8BlacknessRGB),        gau8BlacknessRGB }
+};
+
+//! \brief Table of subroutines, indexed by E_ANIMATION_SUBROUTINE
+CODE const S_ANIMATION_SUBROUTINE gasSubroutines[ NUM_SUBROUTINES ] = 
+{
+  {sizeof(gau8ShootingStar),          gau8ShootingStar },
+  {sizeof(gau8ShootingStarRGB),       gau8ShootingStarRGB },
+  {0u,                                NULL },                       // not used on this board
+  {0u,                                NULL },                       // not used on this board
 };
 #endif
 
 
 /***************************************< Global variables >**************************************/
-IDATA U16 gu16NormalTimer;                    //!< Ms resolution timer for normal LED animation
-IDATA U16 gu16RGBTimer;                       //!< Ms resolution timer for the RGB LED animation
+IDATA U32 gu32NormalTimer;                    //!< Timer of the normal LED animation (VM_TIME() units), the programs may be longer than 65.5 s
+IDATA U32 gu32RGBTimer;                       //!< Timer of the RGB LED animation (VM_TIME() units)
 IDATA U16 gu16LastCall;                       //!< The last time the main cycle was called
 // Local variables
-static IDATA U8 u8LastState = 0xFFu;          //!< Previously executed instruction index for normal LEDs
-static IDATA U8 u8RepetitionCounter = 0u;     //!< Instruction repetition counter for normal LEDs
-static IDATA U8 u8LastStateRGB = 0xFFu;       //!< Previously executed instruction index for RGB LED
-static IDATA U8 u8RepetitionCounterRGB = 0u;  //!< Instruction repetition counter for RGB LED
+static IDATA U8 gau8LEDLevels[ LEDS_NUM ];    //!< Brightness levels of the normal LEDs [0; ANIMATION_LEVEL_MAX]
+static IDATA U8 gau8RGBLevels[ NUM_RGBLED_COLORS ];  //!< Brightness levels of the RGB LED [0; ANIMATION_LEVEL_MAX]
+//! Virtual machine of the normal LEDs
+static IDATA S_ANIMATION_CHANNEL gsChannelNormal = { gau8LEDLevels, &gu32NormalTimer, LEDS_NUM, RIGHT_LEDS_START, STATE_NONE, 0u, 0u, 0xACE1u,
+                                                     { 0u }, 0u, 0u, 0u, 0u, 0u };  // no fade running
+//! Virtual machine of the RGB LED
+static IDATA S_ANIMATION_CHANNEL gsChannelRGB = { gau8RGBLevels, &gu32RGBTimer, NUM_RGBLED_COLORS, RIGHT_RGB_START, STATE_NONE, 0u, 0u, 0x5EEDu,
+                                                  { 0u }, 0u, 0u, 0u, 0u, 0u };  // no fade running
+static DATA BIT gbitLEDsChanged = FALSE;      //!< gau8LEDLevels[] has not been committed to the LED driver yet
+static DATA BIT gbitRGBChanged = FALSE;       //!< gau8RGBLevels[] has not been committed to the RGB LED driver yet
+static IDATA S_ANIMATION_TRACK gsTrackNormal;  //!< Instruction decoder of the normal LEDs
+static IDATA S_ANIMATION_TRACK gsTrackRGB;     //!< Instruction decoder of the RGB LED
+static IDATA U8 gu8ProgramIndex = PROGRAM_NONE;  //!< Index of the animation loaded to the decoders
+#ifdef ANIMATION_LAYERS
+static IDATA S_ANIMATION_LAYER gasLayers[ ANIMATION_LAYERS ];  //!< Programs running over the animation
+#endif
+#ifdef ANIMATION_CROSSFADE_MS
+static IDATA U8 gau8CrossfadeLEDs[ LEDS_NUM ];           //!< Brightness of the normal LEDs when the animation was switched
+static IDATA U8 gau8CrossfadeRGB[ NUM_RGBLED_COLORS ];   //!< Brightness of the RGB LED when the animation was switched
+static IDATA U16 gu16CrossfadeElapsed = VM_TIME( ANIMATION_CROSSFADE_MS );  //!< Time since the switch, the crossfade is over at ANIMATION_CROSSFADE_MS
+#endif
+#ifdef ANIMATION_IN_PENDSV
+static volatile IDATA U16 gu16Wakeup;                    //!< Timer value (VM_TIMER()) when the next cycle is due
+static volatile DATA BIT gbitWakeupScheduled = FALSE;    //!< gu16Wakeup is valid, the frame interrupt may pend the next cycle
+static volatile IDATA U8 gu8RequestedAnimation = PROGRAM_NONE;  //!< Animation to be switched to by the next cycle, see Animation_Set()
+#endif
 
 
 /***************************************< Static function definitions >**************************************/
 static I8 SaturateBrightness( U8* pu8BrightnessVariable );
+static void FlowSource( U8* pu8Levels, const I8* pi8Values, U8 u8From, U8 u8To );
+static U16 Ease( U16 u16Progress, U8 u8Easing );
+static BOOL UpdateFade( S_ANIMATION_CHANNEL* psChannel );
+static U8 ChannelBrightness( const S_ANIMATION_CHANNEL* psChannel, U8 u8Index );
+#ifdef ANIMATION_CROSSFADE_MS
+static U8 Crossfade( U8 u8From, U8 u8To, U16 u16Weight );
+#endif
+#ifdef ANIMATION_LAYERS
+static U8 Blend( U8 u8Base, U8 u8Layer, U8 u8Blend );
+#endif
+static U8 ComposedBrightness( const S_ANIMATION_CHANNEL* psChannel, U8 u8Index );
+static void PublishLevels( void );
+static const U8 CODE* DecodeInstruction( const U8 CODE* pu8Code, U8 u8NumValues, S_ANIMATION_INSTRUCTION* psInstruction );
+static void RewindTrack( S_ANIMATION_TRACK* psTrack );
+static void FollowControlFlow( S_ANIMATION_TRACK* psTrack );
+static void DecodeNextInstruction( S_ANIMATION_TRACK* psTrack );
+static const S_ANIMATION_INSTRUCTION* SeekInstruction( S_ANIMATION_TRACK* psTrack, U32 u32Timer, U16* pu16State );
+static void LoadProgram( void );
+#ifdef ANIMATION_LAYERS
+static void StartLayer( const U8 CODE* pu8Operands, U8 u8NumValues );
+static void RunLayers( void );
+#endif
+static U8 NextRandom( S_ANIMATION_CHANNEL* psChannel );
+static void Generate( S_ANIMATION_CHANNEL* psChannel, const S_ANIMATION_INSTRUCTION* psInstruction );
+static void ExecuteInstruction( S_ANIMATION_CHANNEL* psChannel, const S_ANIMATION_INSTRUCTION* psInstruction, U16 u16State );
+static void SwitchAnimation( U8 u8AnimationIndex );
+#ifdef ANIMATION_IN_PENDSV
+static U32 TimeToNextInstruction( const S_ANIMATION_TRACK* psTrack, U32 u32Timer );
+static void ScheduleWakeup( void );
+#endif
 
 
 /***************************************< Private functions >**************************************/
@@ -1345,452 +1687,1200 @@ static I8 SaturateBrightness( U8* pu8BrightnessVariable )
     i8Return = (I8)*pu8BrightnessVariable;
     *pu8BrightnessVariable = 0u;
   }
-  else if( (I8)*pu8BrightnessVariable > 15u )
+  else if( (I8)*pu8BrightnessVariable > ANIMATION_LEVEL_MAX )
   {
-    i8Return = (I8)*pu8BrightnessVariable - 15;
-    *pu8BrightnessVariable = 15u;
+    i8Return = (I8)*pu8BrightnessVariable - ANIMATION_LEVEL_MAX;
+    *pu8BrightnessVariable = ANIMATION_LEVEL_MAX;
   }
   return i8Return;
 }
 
-
-/***************************************< Public functions >**************************************/
 //----------------------------------------------------------------------------
-//! \brief  Initialize layer
-//! \param  -
+//! \brief  Adds the values of a source instruction to one side, the overflows flow towards the end
+//! \param  *pu8Levels: brightness levels of the output
+//! \param  *pi8Values: values of the instruction
+//! \param  u8From: first level of the side in the direction of the flow
+//! \param  u8To: last level of the side, it keeps the overflow beyond the range
 //! \return -
-//! \global All globals in this layer.
-//! \note   Should be called in the init block of the firmware.
+//! \global -
+//! \note   One pass, with the same result as adding the values one by one from u8From, each followed by
+//!         the saturation of all the levels up to u8To. A level saturated by the carry of the previous
+//!         ones can't overflow the other way by its own value in [-15; 15], so a single carry is enough.
 //-----------------------------------------------------------------------------
-void Animation_Init( void )
+static void FlowSource( U8* pu8Levels, const I8* pi8Values, U8 u8From, U8 u8To )
 {
-  gu16NormalTimer = 0u;
-  gu16RGBTimer = 0u;
-  gu16LastCall = Util_GetTimerMs();
+  U8 u8Index = u8From;
+  U8 u8Step = ( u8From < u8To ) ? 1u : 0xFFu;  // -1 in U8 arithmetic
+  I8 i8Carry = 0;
+  
+  while( u8Index != u8To )
+  {
+    pu8Levels[ u8Index ] += i8Carry;  // the overflow of the previous levels arrives first
+    i8Carry = SaturateBrightness( &pu8Levels[ u8Index ] );
+    pu8Levels[ u8Index ] += pi8Values[ u8Index ];
+    i8Carry += SaturateBrightness( &pu8Levels[ u8Index ] );
+    u8Index += u8Step;
+  }
+  pu8Levels[ u8To ] += i8Carry + pi8Values[ u8To ];
+  SaturateBrightness( &pu8Levels[ u8To ] );
 }
 
 //----------------------------------------------------------------------------
-//! \brief  Check timer and update LED brightnesses based on the animation.
-//! \param  -
-//! \return -
+//! \brief  Applies an easing curve to the progress of a fade
+//! \param  u16Progress: linear progress [0; FADE_PROGRESS_MAX)
+//! \param  u8Easing: easing curve (E_ANIMATION_EASING)
+//! \return Eased progress [0; FADE_PROGRESS_MAX)
 //! \global -
-//! \note   Should be called from main cycle.
 //-----------------------------------------------------------------------------
-void Animation_Cycle( void )
+static U16 Ease( U16 u16Progress, U8 u8Easing )
 {
-  U8  u8AnimationState;
-  U16 u16StateTimer = 0u;
-  U16 u16TimeNow = Util_GetTimerMs();
-  U8  u8Index, u8InnerIndex;
-  U8  u8OpCode;
-  U8  u8Temp;
-  I8  i8Change;
+  U16 u16Return = u16Progress;
   
-  // Check if time has elapsed since last call
-  if( u16TimeNow != gu16LastCall )
+  switch( u8Easing )
   {
-    // Increase the synchronized timer with the difference
-    DISABLE_IT;
-    gu16NormalTimer += ( u16TimeNow - gu16LastCall );
-    gu16RGBTimer += ( u16TimeNow - gu16LastCall );
-    ENABLE_IT;
+    case EASE_IN:
+      u16Return = (U16)( ( (U32)u16Progress * u16Progress ) >> 8u );
+      break;
+    
+    case EASE_OUT:
+      u16Return = FADE_PROGRESS_MAX - (U16)( ( (U32)( FADE_PROGRESS_MAX - u16Progress ) * ( FADE_PROGRESS_MAX - u16Progress ) ) >> 8u );
+      break;
+    
+    case EASE_IN_OUT:  // 3x^2 - 2x^3
+      u16Return = (U16)( ( (U32)u16Progress * u16Progress * ( ( 3u * FADE_PROGRESS_MAX ) - ( 2u * u16Progress ) ) ) >> 16u );
+      break;
+    
+    default:           // EASE_LINEAR
+      break;
+  }
+  return u16Return;
+}
 
-    // Make sure not to overindex arrays
-    if( gsPersistentData.u8AnimationIndex >= NUM_ANIMATIONS )
+//----------------------------------------------------------------------------
+//! \brief  Calculates the rate of a fade
+//! \param  u32Duration: length of the fade (VM_TIME() units), not 0
+//! \return FADE_PROGRESS_MAX / u32Duration with FADE_RATE_SHIFT fraction bits, never faster
+//! \global gau16FadeReciprocals[]
+//! \note   The length is normalized by shifts and rounded up to 8 significant bits, so the progress may fall behind
+//!         by 1 %, but never reaches FADE_PROGRESS_MAX before the end of the fade. There's no division.
+//-----------------------------------------------------------------------------
+static U32 FadeRate( U32 u32Duration )
+{
+  U32 u32Rate;
+  U8  u8Up = 0u;
+  U8  u8Down = 0u;
+  
+  while( u32Duration < FADE_RECIPROCAL_MIN )
+  {
+    u32Duration <<= 1u;
+    u8Up++;
+  }
+  while( u32Duration > FADE_RECIPROCAL_MAX )
+  {
+    u32Duration = ( u32Duration + 1u ) >> 1u;
+    u8Down++;
+  }
+  u32Rate = (U32)gau16FadeReciprocals[ u32Duration - FADE_RECIPROCAL_MIN ] << FADE_RECIPROCAL_SHIFT;
+  return ( u32Rate << u8Up ) >> u8Down;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Follows the running fade of an output with its timer
+//! \param  *psChannel: the virtual machine of the output
+//! \return TRUE if the output has to be committed again
+//! \global -
+//-----------------------------------------------------------------------------
+static BOOL UpdateFade( S_ANIMATION_CHANNEL* psChannel )
+{
+  BOOL bReturn = FALSE;
+  U32  u32Elapsed;
+  U16  u16Progress;
+  
+  if( 0u != psChannel->u32FadeDuration )
+  {
+    u32Elapsed = *psChannel->pu32Timer - psChannel->u32FadeStart;
+    if( u32Elapsed >= psChannel->u32FadeDuration )  // finished, the levels are the target already
     {
-      gsPersistentData.u8AnimationIndex = 0u;
+      psChannel->u32FadeDuration = 0u;
+      bReturn = TRUE;
     }
+    else
+    {
+      u16Progress = Ease( (U16)( ( u32Elapsed * psChannel->u32FadeRate ) >> FADE_RATE_SHIFT ), psChannel->u8FadeEasing );
+      if( u16Progress != psChannel->u16FadeProgress )
+      {
+        psChannel->u16FadeProgress = u16Progress;
+        bReturn = TRUE;
+      }
+    }
+  }
+  return bReturn;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Logical brightness of a level of an output
+//! \param  *psChannel: the virtual machine of the output
+//! \param  u8Index: index of the level
+//! \return Brightness [0; LED_BRIGHTNESS_MAX]
+//! \global -
+//! \note   During a fade it's interpolated in the full brightness range, not in animation levels.
+//-----------------------------------------------------------------------------
+static U8 ChannelBrightness( const S_ANIMATION_CHANNEL* psChannel, U8 u8Index )
+{
+  U16 u16Level = (U16)psChannel->pu8Levels[ u8Index ] * FADE_PROGRESS_MAX;
+  
+  if( 0u != psChannel->u32FadeDuration )
+  {
+    u16Level = ( (U16)psChannel->au8FadeFrom[ u8Index ] * ( FADE_PROGRESS_MAX - psChannel->u16FadeProgress ) )
+             + ( (U16)psChannel->pu8Levels[ u8Index ] * psChannel->u16FadeProgress );
+  }
+  return (U8)( ( (U32)u16Level * ANIMATION_LEVEL_STEP ) >> 8u );
+}
+
+#ifdef ANIMATION_LAYERS
+//----------------------------------------------------------------------------
+//! \brief  Merges the brightness of a layer into the brightness below it
+//! \param  u8Base: brightness below the layer
+//! \param  u8Layer: brightness of the layer
+//! \param  u8Blend: blend mode (E_ANIMATION_BLEND)
+//! \return Merged brightness
+//! \global -
+//-----------------------------------------------------------------------------
+static U8 Blend( U8 u8Base, U8 u8Layer, U8 u8Blend )
+{
+  U8 u8Return = u8Base;
+  
+  switch( u8Blend )
+  {
+    case BLEND_ADD:
+      u8Return = ( u8Layer > ( LED_BRIGHTNESS_MAX - u8Base ) ) ? LED_BRIGHTNESS_MAX : ( u8Base + u8Layer );
+      break;
     
-    // --------------------------------------< For the normal LEDs
-    // Calculate the state of the animation
-    for( u8AnimationState = 0u; u8AnimationState < gasAnimations[ gsPersistentData.u8AnimationIndex ].u8AnimationLengthNormal; u8AnimationState++ )
+    case BLEND_MULTIPLY:
+      u8Return = (U8)( ( (U16)u8Base * ( u8Layer + 1u ) ) >> 8u );
+      break;
+    
+    case BLEND_REPLACE:
+      u8Return = u8Layer;
+      break;
+    
+    default:  // BLEND_MAX
+      if( u8Layer > u8Base )
+      {
+        u8Return = u8Layer;
+      }
+      break;
+  }
+  return u8Return;
+}
+#endif
+
+//----------------------------------------------------------------------------
+//! \brief  Logical brightness of an output, with the layers running over it
+//! \param  *psChannel: the virtual machine of the output
+//! \param  u8Index: index of the level
+//! \return Brightness [0; LED_BRIGHTNESS_MAX]
+//! \global gasLayers[]
+//-----------------------------------------------------------------------------
+static U8 ComposedBrightness( const S_ANIMATION_CHANNEL* psChannel, U8 u8Index )
+{
+  U8 u8Return = ChannelBrightness( psChannel, u8Index );
+#ifdef ANIMATION_LAYERS
+  U8 u8Layer;
+  
+  for( u8Layer = 0u; u8Layer < ANIMATION_LAYERS; u8Layer++ )
+  {
+    if( ( LAYER_FREE != gasLayers[ u8Layer ].u8Subroutine ) && ( psChannel->u8NumValues == gasLayers[ u8Layer ].sChannel.u8NumValues )
+     && ( 0u != ( gasLayers[ u8Layer ].u16Mask & ( 1u << u8Index ) ) ) )
+    {
+      u8Return = Blend( u8Return, ChannelBrightness( &gasLayers[ u8Layer ].sChannel, u8Index ), gasLayers[ u8Layer ].u8Blend );
+    }
+  }
+#endif
+  return u8Return;
+}
+
+#ifdef ANIMATION_CROSSFADE_MS
+//----------------------------------------------------------------------------
+//! \brief  Blends the brightness of the outgoing animation into the incoming one
+//! \param  u8From: brightness of the outgoing animation
+//! \param  u8To: brightness of the incoming animation
+//! \param  u16Weight: weight of the incoming animation [0; FADE_PROGRESS_MAX]
+//! \return Blended brightness
+//! \global -
+//-----------------------------------------------------------------------------
+static U8 Crossfade( U8 u8From, U8 u8To, U16 u16Weight )
+{
+  return (U8)( ( ( (U16)u8From * ( FADE_PROGRESS_MAX - u16Weight ) ) + ( (U16)u8To * u16Weight ) ) >> 8u );
+}
+#endif
+
+//----------------------------------------------------------------------------
+//! \brief  Commits the changed animation levels to the LED drivers
+//! \param  -
+//! \return -
+//! \global gsChannelNormal, gsChannelRGB, gau8LEDBrightness[], gau8RGBLEDs[], gbitLEDsChanged, gbitRGBChanged,
+//!         gau8CrossfadeLEDs[], gau8CrossfadeRGB[], gu16CrossfadeElapsed
+//! \note   The drivers use the full logical brightness range, the animations use [0; ANIMATION_LEVEL_MAX].
+//!         A commit refused by a driver is retried in the next call.
+//-----------------------------------------------------------------------------
+static void PublishLevels( void )
+{
+  U8 u8Index;
+#ifdef ANIMATION_CROSSFADE_MS
+  U16 u16Weight = (U16)( ( (U32)gu16CrossfadeElapsed * CROSSFADE_RATE ) >> FADE_RATE_SHIFT );  // no division, see CROSSFADE_RATE
+#endif
+  
+  if( gbitLEDsChanged )
+  {
+    for( u8Index = 0u; u8Index < LEDS_NUM; u8Index++ )
+    {
+      gau8LEDBrightness[ u8Index ] = ComposedBrightness( &gsChannelNormal, u8Index );
+#ifdef ANIMATION_CROSSFADE_MS
+      gau8LEDBrightness[ u8Index ] = Crossfade( gau8CrossfadeLEDs[ u8Index ], gau8LEDBrightness[ u8Index ], u16Weight );
+#endif
+    }
+    gbitLEDsChanged = !LED_Commit();
+  }
+  if( gbitRGBChanged )
+  {
+    for( u8Index = 0u; u8Index < NUM_RGBLED_COLORS; u8Index++ )
+    {
+      gau8RGBLEDs[ u8Index ] = ComposedBrightness( &gsChannelRGB, u8Index );
+#ifdef ANIMATION_CROSSFADE_MS
+      gau8RGBLEDs[ u8Index ] = Crossfade( gau8CrossfadeRGB[ u8Index ], gau8RGBLEDs[ u8Index ], u16Weight );
+#endif
+    }
+    gbitRGBChanged = !RGBLED_Commit();
+  }
+}
+
+
+//----------------------------------------------------------------------------
+//! \brief  Decodes one packed instruction
+//! \param  *pu8Code: the packed instruction
+//! \param  u8NumValues: number of brightness values in the instruction
+//! \param  *psInstruction: output, holding the values of the previous instruction (base of a delta load)
+//! \return Pointer to the next packed instruction
+//! \global -
+//-----------------------------------------------------------------------------
+static const U8 CODE* DecodeInstruction( const U8 CODE* pu8Code, U8 u8NumValues, S_ANIMATION_INSTRUCTION* psInstruction )
+{
+  U16 u16Signs = 0u;
+  U8  u8Index;
+  U8  u8Header;
+  I8  i8Value;
+  
+  u8Header = pu8Code[ 0u ];
+  psInstruction->u32Timing = (U16)pu8Code[ 1u ] | ( (U16)pu8Code[ 2u ] << 8u );
+#ifdef ANIMATION_TICK_TIMEBASE
+  if( TIMING_IN_TICKS & psInstruction->u32Timing )
+  {
+    psInstruction->u32Timing &= (U16)~TIMING_IN_TICKS;
+  }
+  else  // in ms
+  {
+    psInstruction->u32Timing = VM_TIME( psInstruction->u32Timing );
+  }
+#endif
+  pu8Code += 3u;
+  psInstruction->u8AnimationOpcode = u8Header & (U8)~OPCODE_EXTENDED;
+  psInstruction->u8AnimationOperand = 0u;
+  psInstruction->u8Generator = 0u;
+  psInstruction->u8GeneratorParameter = 0u;
+  if( OPCODE_DELTA == u8Header )  // only the changed values are stored
+  {
+    for( u8Index = 0u; u8Index < pu8Code[ 0u ]; u8Index++ )
     {
-      u16StateTimer += gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].u16TimingMs;
-      if( u16StateTimer > gu16NormalTimer )
+      if( ( pu8Code[ 1u + u8Index ] >> 4u ) < u8NumValues )
       {
-        break;
+        psInstruction->ai8Values[ pu8Code[ 1u + u8Index ] >> 4u ] = (I8)( pu8Code[ 1u + u8Index ] & 0x0Fu );
       }
     }
-    if( u8AnimationState >= gasAnimations[ gsPersistentData.u8AnimationIndex ].u8AnimationLengthNormal )
+    pu8Code += 1u + pu8Code[ 0u ];
+  }
+  else
+  {
+    if( 0u != ( OPCODE_EXTENDED & u8Header ) )
     {
-      // restart animation
-      u8AnimationState = 0u;
-      DISABLE_IT;
-      gu16NormalTimer = 0u;
-      gu16RGBTimer = 0u;
-      ENABLE_IT;
+      for( u8Index = 0u; u8Index < ( ( u8NumValues + 7u ) / 8u ); u8Index++ )
+      {
+        u16Signs |= (U16)*pu8Code << ( 8u * u8Index );
+        pu8Code++;
+      }
     }
-    if( u8LastState != u8AnimationState )  // next instruction
+    for( u8Index = 0u; u8Index < u8NumValues; u8Index++ )
     {
-      u8OpCode = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].u8AnimationOpcode;
-      // Just a load instruction, nothing more
-      if( LOAD == u8OpCode )
+      i8Value = (I8)( ( pu8Code[ u8Index >> 1u ] >> ( ( u8Index & 1u ) * 4u ) ) & 0x0Fu );
+      if( 0u != ( u16Signs & ( 1u << u8Index ) ) )
       {
-        memcpy( gau8LEDBrightness, (void*)gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness, LEDS_NUM );
-        u8LastState = u8AnimationState;
+        i8Value = -i8Value;
       }
-      else  // Other opcodes -- IMPORTANT: the order of operations are fixed!
+      psInstruction->ai8Values[ u8Index ] = i8Value;
+    }
+    pu8Code += ( u8NumValues + 1u ) / 2u;
+    if( 0u != ( OPCODE_EXTENDED & u8Header ) )
+    {
+      psInstruction->u8AnimationOperand = *pu8Code;
+      pu8Code++;
+    }
+    else if( IS_GENERATOR( u8Header ) )
+    {
+      psInstruction->u8Generator = u8Header >> 4u;
+      psInstruction->u8GeneratorParameter = pu8Code[ 0u ];
+      psInstruction->u8AnimationOperand = pu8Code[ 1u ];
+      psInstruction->u8AnimationOpcode = ( 0u != pu8Code[ 1u ] ) ? ( GENERATE | REPEAT ) : GENERATE;
+      pu8Code += 2u;
+    }
+  }
+  return pu8Code;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Restarts the decoding of a track from its first instruction
+//! \param  *psTrack: the track
+//! \return -
+//! \global -
+//-----------------------------------------------------------------------------
+static void RewindTrack( S_ANIMATION_TRACK* psTrack )
+{
+  psTrack->pu8Next = psTrack->pu8Code;
+  psTrack->pu8BlockEnd = psTrack->pu8CodeEnd;
+  psTrack->u8Depth = 0u;
+  psTrack->u16TimeScale = TIME_SCALE_UNITY;
+  psTrack->u16Decoded = 0u;
+  psTrack->u8Newest = 0u;
+  psTrack->u32WindowStart = 0u;
+  psTrack->au32Deadline[ 0u ] = 0u;
+  psTrack->au32Deadline[ 1u ] = 0u;
+  memset( psTrack->asWindow[ 0u ].ai8Values, 0, LEDS_NUM );  // the first delta load is given relative to all zeros
+  FollowControlFlow( psTrack );
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Steps over the control flow instructions at the decoding position of a track
+//! \param  *psTrack: the track
+//! \return -
+//! \global gasSubroutines[], gasLayers[]
+//! \note   Afterwards pu8Next points to an instruction taking time, or to pu8BlockEnd at the end of the track.
+//-----------------------------------------------------------------------------
+static void FollowControlFlow( S_ANIMATION_TRACK* psTrack )
+{
+  const U8 CODE* pu8Code = psTrack->pu8Next;
+  const S_ANIMATION_SUBROUTINE CODE* psSubroutine;
+  S_ANIMATION_FRAME* psFrame;
+  
+  while( ( ( pu8Code == psTrack->pu8BlockEnd ) && ( 0u != psTrack->u8Depth ) )
+      || ( ( pu8Code != psTrack->pu8BlockEnd ) && IS_CONTROL_FLOW( *pu8Code ) ) )
+  {
+    if( pu8Code == psTrack->pu8BlockEnd )  // end of a subroutine: return
+    {
+      psTrack->u8Depth--;
+      psFrame = &psTrack->asStack[ psTrack->u8Depth ];
+      if( 0u == psFrame->u8Count )  // an unclosed loop is just dropped
       {
-        // Add operation
-        if( ADD & u8OpCode )
-        {
-          for( u8Index = 0u; u8Index < LEDS_NUM; u8Index++ )
-          {
-            gau8LEDBrightness[ u8Index ] += gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ u8Index ];
-            if( gau8LEDBrightness[ u8Index ] > 15u )  // overflow/underflow happened
-            {
-              gau8LEDBrightness[ u8Index ] = 0u;
-            }
-          }
-        }
-        // Right shift operation
-        if( RSHIFT & u8OpCode )
-        {
-          u8Temp = gau8LEDBrightness[ LEDS_NUM - 1u ];
-          for( u8Index = LEDS_NUM - 1u; u8Index > 0u; u8Index-- )
-          {
-            gau8LEDBrightness[ u8Index ] = gau8LEDBrightness[ u8Index - 1u ];
-          }
-          gau8LEDBrightness[ 0u ] = u8Temp;
-        }
-        // Left shift operation
-        if( LSHIFT & u8OpCode )
-        {
-          u8Temp = gau8LEDBrightness[ 0u ];
-          for( u8Index = 0u; u8Index < (LEDS_NUM - 1u); u8Index++ )
-          {
-            gau8LEDBrightness[ u8Index ] = gau8LEDBrightness[ u8Index + 1u ];
-          }
-          gau8LEDBrightness[ LEDS_NUM - 1u ] = u8Temp;
-        }
-/*
-        // Upward move operation
-        if( UMOVE & u8OpCode )
-        {
-          // Left side
-          for( u8Index = 0u; u8Index < (RIGHT_LEDS_START - 1u); u8Index++ )
-          {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ u8Index ];
-            gau8LEDBrightness[ u8Index ] -= i8Change;
-            for( u8InnerIndex = u8Index; u8InnerIndex < (RIGHT_LEDS_START - 1u); u8InnerIndex++ )
-            {
-              i8Change += SaturateBrightness( &gau8LEDBrightness[ u8InnerIndex ] );
-              gau8LEDBrightness[ u8InnerIndex + 1u ] += i8Change;
-              i8Change = SaturateBrightness( &gau8LEDBrightness[ u8InnerIndex + 1u ] );
-            }
-          }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ RIGHT_LEDS_START - 1u ];
-          gau8LEDBrightness[ RIGHT_LEDS_START - 1u ] -= i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ RIGHT_LEDS_START - 1u ] );
-          // Right side
-          for( u8Index = LEDS_NUM - 1u; u8Index > RIGHT_LEDS_START; u8Index-- )
+        pu8Code = psFrame->pu8Continue;
+        psTrack->pu8BlockEnd = psFrame->pu8BlockEnd;
+        psTrack->u16TimeScale = psFrame->u16TimeScale;
+      }
+    }
+    else
+    {
+      switch( *pu8Code )
+      {
+        case OPCODE_LOOP:   // Loop start or subroutine call: a new frame
+        case OPCODE_CALL:
+          if( ANIMATION_STACK_DEPTH == psTrack->u8Depth )  // nested too deep, end the track here
           {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ u8Index ];
-            if( (I8)gau8LEDBrightness[ u8Index ] - i8Change < 0u )  // saturation downwards
-            {
-              gau8LEDBrightness[ u8Index - 1u ] += gau8LEDBrightness[ u8Index ];
-            }
-            else  // no saturation
-            {
-              gau8LEDBrightness[ u8Index - 1u ] += i8Change;
-            }
-            gau8LEDBrightness[ u8Index ] -= i8Change;
-            SaturateBrightness( &gau8LEDBrightness[ u8Index ] );
-            SaturateBrightness( &gau8LEDBrightness[ u8Index - 1u ] );  // saturate the next LED too
+            psTrack->u8Depth = 0u;
+            psTrack->pu8BlockEnd = pu8Code;
           }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ RIGHT_LEDS_START ];
-          gau8LEDBrightness[ RIGHT_LEDS_START ] -= i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ RIGHT_LEDS_START ] );
-        }
-        // Downward move operation
-        if( DMOVE & u8OpCode )
-        {
-          //TODO: this works for positive move values only!
-          // Left side
-          for( u8Index = (RIGHT_LEDS_START - 1u); u8Index > 0u ; u8Index-- )
+          else
           {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ u8Index ];
-            if( (I8)gau8LEDBrightness[ u8Index ] - i8Change < 0u )  // saturation downwards
+            psFrame = &psTrack->asStack[ psTrack->u8Depth ];
+            psTrack->u8Depth++;
+            psFrame->pu8BlockEnd = psTrack->pu8BlockEnd;
+            psFrame->u16TimeScale = psTrack->u16TimeScale;
+            if( OPCODE_LOOP == *pu8Code )
             {
-              gau8LEDBrightness[ u8Index - 1u ] += gau8LEDBrightness[ u8Index ];
+              psFrame->u8Count = ( 0u != pu8Code[ 1u ] ) ? pu8Code[ 1u ] : 1u;  // 0 would mark a call
+              pu8Code += 2u;
+              psFrame->pu8Continue = pu8Code;
             }
-            else  // no saturation
+            else
             {
-              gau8LEDBrightness[ u8Index - 1u ] += i8Change;
+              psFrame->u8Count = 0u;
+              psFrame->pu8Continue = pu8Code + 3u;
+              psSubroutine = &gasSubroutines[ pu8Code[ 1u ] ];
+              psTrack->u16TimeScale = (U16)( ( (U32)psTrack->u16TimeScale * pu8Code[ 2u ] ) >> TIME_SCALE_SHIFT );
+              if( psTrack->u16TimeScale > TIME_SCALE_MAX )
+              {
+                psTrack->u16TimeScale = TIME_SCALE_MAX;
+              }
+              pu8Code = psSubroutine->pu8Code;
+              psTrack->pu8BlockEnd = psSubroutine->pu8Code + psSubroutine->u16CodeSize;
             }
-            gau8LEDBrightness[ u8Index ] -= i8Change;
-            SaturateBrightness( &gau8LEDBrightness[ u8Index ] );
-            SaturateBrightness( &gau8LEDBrightness[ u8Index - 1u ] );  // saturate the next LED too
           }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ 0u ];
-          gau8LEDBrightness[ 0u ] -= i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ 0u ] );
-          // Right side
-          for( u8Index = RIGHT_LEDS_START; u8Index < (LEDS_NUM - 1u); u8Index++ )
+          break;
+        
+        case OPCODE_END_LOOP:  // Loop end: start the next pass, or leave the loop
+          pu8Code++;
+          if( 0u != psTrack->u8Depth )
           {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ u8Index ];
-            if( (I8)gau8LEDBrightness[ u8Index ] - i8Change < 0u )  // saturation downwards
+            psFrame = &psTrack->asStack[ psTrack->u8Depth - 1u ];
+            if( psFrame->u8Count > 1u )
             {
-              gau8LEDBrightness[ u8Index + 1u ] += gau8LEDBrightness[ u8Index ];
+              psFrame->u8Count--;
+              pu8Code = psFrame->pu8Continue;
             }
-            else  // no saturation
+            else if( 0u != psFrame->u8Count )  // last pass
             {
-              gau8LEDBrightness[ u8Index + 1u ] += i8Change;
+              psTrack->u8Depth--;
             }
-            gau8LEDBrightness[ u8Index ] -= i8Change;
-            SaturateBrightness( &gau8LEDBrightness[ u8Index ] );
-            SaturateBrightness( &gau8LEDBrightness[ u8Index + 1u ] );  // saturate the next LED too
           }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].au8LEDBrightness[ LEDS_NUM - 1u ];
-          gau8LEDBrightness[ LEDS_NUM - 1u ] -= i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ LEDS_NUM - 1u ] );
-        }
-*/
-        // Upward source instruction
-        if( USOURCE & u8OpCode )
-        {
-          // Left side
-          for( u8Index = 0u; u8Index < (RIGHT_LEDS_START - 1u); u8Index++ )
-          {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ u8Index ];
-            gau8LEDBrightness[ u8Index ] += i8Change;
-            for( u8InnerIndex = u8Index; u8InnerIndex < (RIGHT_LEDS_START - 1u); u8InnerIndex++ )
-            {
-              gau8LEDBrightness[ u8InnerIndex + 1u ] += SaturateBrightness( &gau8LEDBrightness[ u8InnerIndex ] );
-            }
-          }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ RIGHT_LEDS_START - 1u ];
-          gau8LEDBrightness[ RIGHT_LEDS_START - 1u ] += i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ RIGHT_LEDS_START - 1u ] );
-          // Right side
-          for( u8Index = LEDS_NUM - 1u; u8Index > RIGHT_LEDS_START; u8Index-- )
-          {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ u8Index ];
-            gau8LEDBrightness[ u8Index ] += i8Change;
-            for( u8InnerIndex = LEDS_NUM - 1u; u8InnerIndex > RIGHT_LEDS_START; u8InnerIndex-- )
-            {
-              gau8LEDBrightness[ u8InnerIndex - 1u ] += SaturateBrightness( &gau8LEDBrightness[ u8InnerIndex ] );
-            }
-          }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ RIGHT_LEDS_START ];
-          gau8LEDBrightness[ RIGHT_LEDS_START ] += i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ RIGHT_LEDS_START ] );
-        }
-        // Downward source instruction
-        if( DSOURCE & u8OpCode )
+          break;
+        
+        case OPCODE_JUMP:   // Jump: the subroutine replaces the rest of the code block
+          psSubroutine = &gasSubroutines[ pu8Code[ 1u ] ];
+          pu8Code = psSubroutine->pu8Code;
+          psTrack->pu8BlockEnd = psSubroutine->pu8Code + psSubroutine->u16CodeSize;
+          break;
+        
+        case OPCODE_LAYER:  // Layer: the subroutine runs on its own, the track goes on
+#ifdef ANIMATION_LAYERS
+          StartLayer( &pu8Code[ 1u ], psTrack->u8NumValues );
+#endif
+          pu8Code += 5u;
+          break;
+        
+        default:            // Unknown instruction, end the track here
+          psTrack->u8Depth = 0u;
+          psTrack->pu8BlockEnd = pu8Code;
+          break;
+      }
+    }
+  }
+  psTrack->pu8Next = pu8Code;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Decodes the next instruction of a track into its window
+//! \param  *psTrack: the track
+//! \return -
+//! \global -
+//! \note   The older instruction of the window is dropped.
+//-----------------------------------------------------------------------------
+static void DecodeNextInstruction( S_ANIMATION_TRACK* psTrack )
+{
+  U8 u8Slot = 1u - psTrack->u8Newest;
+  S_ANIMATION_INSTRUCTION* psInstruction = &psTrack->asWindow[ u8Slot ];
+  
+  psTrack->u32WindowStart = psTrack->au32Deadline[ u8Slot ];
+  memcpy( psInstruction->ai8Values, psTrack->asWindow[ psTrack->u8Newest ].ai8Values, LEDS_NUM );
+  psTrack->pu8Next = DecodeInstruction( psTrack->pu8Next, psTrack->u8NumValues, psInstruction );
+  if( TIME_SCALE_UNITY != psTrack->u16TimeScale )  // in a scaled subroutine call
+  {
+    psInstruction->u32Timing = ( psInstruction->u32Timing * psTrack->u16TimeScale ) >> TIME_SCALE_SHIFT;
+  }
+  psTrack->au32Deadline[ u8Slot ] = psTrack->au32Deadline[ psTrack->u8Newest ] + psInstruction->u32Timing;
+  psTrack->u8Newest = u8Slot;
+  psTrack->u16Decoded++;
+  FollowControlFlow( psTrack );
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Finds the instruction belonging to the given time
+//! \param  *psTrack: the track
+//! \param  u32Timer: animation timer of the track
+//! \param  *pu16State: output, index of the instruction in the decoding order (number of instructions if the track is over)
+//! \return Pointer to the decoded instruction, NULL if the track is over
+//! \global -
+//! \note   The timer moves forward by a few ms between calls, or steps back by one instruction on repeat.
+//!         Stepping back further rewinds the decoding to the first instruction.
+//-----------------------------------------------------------------------------
+static const S_ANIMATION_INSTRUCTION* SeekInstruction( S_ANIMATION_TRACK* psTrack, U32 u32Timer, U16* pu16State )
+{
+  const S_ANIMATION_INSTRUCTION* psReturn = NULL;
+  
+  if( u32Timer < psTrack->u32WindowStart )
+  {
+    RewindTrack( psTrack );
+  }
+  while( ( u32Timer >= psTrack->au32Deadline[ psTrack->u8Newest ] ) && ( psTrack->pu8Next != psTrack->pu8BlockEnd ) )
+  {
+    DecodeNextInstruction( psTrack );
+  }
+  if( u32Timer < psTrack->au32Deadline[ 1u - psTrack->u8Newest ] )
+  {
+    psReturn = &psTrack->asWindow[ 1u - psTrack->u8Newest ];
+    *pu16State = psTrack->u16Decoded - 2u;
+  }
+  else if( u32Timer < psTrack->au32Deadline[ psTrack->u8Newest ] )
+  {
+    psReturn = &psTrack->asWindow[ psTrack->u8Newest ];
+    *pu16State = psTrack->u16Decoded - 1u;
+  }
+  else
+  {
+    *pu16State = psTrack->u16Decoded;
+  }
+  return psReturn;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Loads the selected animation to the instruction decoders
+//! \param  -
+//! \return -
+//! \global gasAnimations[], gsPersistentData, gsTrackNormal, gsTrackRGB, gu8ProgramIndex, gasLayers[]
+//-----------------------------------------------------------------------------
+static void LoadProgram( void )
+{
+  const S_ANIMATION CODE* psAnimation = &gasAnimations[ gsPersistentData.u8AnimationIndex ];
+#ifdef ANIMATION_LAYERS
+  U8 u8Layer;
+  
+  // The layers of the previous animation are stopped, the tracks start the new ones
+  for( u8Layer = 0u; u8Layer < ANIMATION_LAYERS; u8Layer++ )
+  {
+    gasLayers[ u8Layer ].u8Subroutine = LAYER_FREE;
+  }
+#endif
+  
+  gsTrackNormal.pu8Code = psAnimation->pu8CodeNormal;
+  gsTrackNormal.pu8CodeEnd = psAnimation->pu8CodeNormal + psAnimation->u16CodeSizeNormal;
+  gsTrackNormal.u8NumValues = LEDS_NUM;
+  RewindTrack( &gsTrackNormal );
+  gsTrackRGB.pu8Code = psAnimation->pu8CodeRGB;
+  gsTrackRGB.pu8CodeEnd = psAnimation->pu8CodeRGB + psAnimation->u16CodeSizeRGB;
+  gsTrackRGB.u8NumValues = NUM_RGBLED_COLORS;
+  RewindTrack( &gsTrackRGB );
+  gu8ProgramIndex = gsPersistentData.u8AnimationIndex;
+}
+
+#ifdef ANIMATION_LAYERS
+//----------------------------------------------------------------------------
+//! \brief  Starts a subroutine on a free layer
+//! \param  *pu8Operands: operands of the LAYER()/TRACK() instruction: subroutine, blend mode, LED mask
+//! \param  u8NumValues: number of brightness values of the track starting the layer, it selects the output
+//! \return -
+//! \global gasLayers[], gasSubroutines[]
+//! \note   A layer already running the subroutine on the same output keeps running. Without a free layer
+//!         the subroutine is not started.
+//-----------------------------------------------------------------------------
+static void StartLayer( const U8 CODE* pu8Operands, U8 u8NumValues )
+{
+  S_ANIMATION_LAYER* psLayer = NULL;
+  U8  u8Subroutine = pu8Operands[ 0u ];
+  U8  u8Blend = pu8Operands[ 1u ];
+  U16 u16Mask = (U16)pu8Operands[ 2u ] | ( (U16)pu8Operands[ 3u ] << 8u );
+  U8  u8Layer;
+  
+  for( u8Layer = 0u; u8Layer < ANIMATION_LAYERS; u8Layer++ )
+  {
+    if( ( u8Subroutine == gasLayers[ u8Layer ].u8Subroutine ) && ( u8NumValues == gasLayers[ u8Layer ].sChannel.u8NumValues ) )
+    {
+      gasLayers[ u8Layer ].u8Blend = u8Blend;  // restart of the track, the layer goes on
+      gasLayers[ u8Layer ].u16Mask = u16Mask;
+      psLayer = NULL;
+      break;
+    }
+    if( ( NULL == psLayer ) && ( LAYER_FREE == gasLayers[ u8Layer ].u8Subroutine ) )
+    {
+      psLayer = &gasLayers[ u8Layer ];
+    }
+  }
+  if( NULL != psLayer )
+  {
+    psLayer->u8Subroutine = u8Subroutine;
+    psLayer->u8Blend = u8Blend;
+    psLayer->u16Mask = u16Mask;
+    psLayer->u32Timer = 0u;
+    memset( psLayer->au8Levels, 0, LEDS_NUM );
+    psLayer->sChannel.pu8Levels = psLayer->au8Levels;
+    psLayer->sChannel.pu32Timer = &psLayer->u32Timer;
+    psLayer->sChannel.u8NumValues = u8NumValues;
+    psLayer->sChannel.u8RightStart = ( LEDS_NUM == u8NumValues ) ? RIGHT_LEDS_START : RIGHT_RGB_START;
+    psLayer->sChannel.u16LastState = STATE_NONE;
+    psLayer->sChannel.u8RepetitionCounter = 0u;
+    psLayer->sChannel.u8Phase = 0u;
+    psLayer->sChannel.u16Random = 0x1D2Bu ^ u8Subroutine;  // never zero
+    psLayer->sChannel.u32FadeDuration = 0u;
+    psLayer->sTrack.pu8Code = gasSubroutines[ u8Subroutine ].pu8Code;
+    psLayer->sTrack.pu8CodeEnd = gasSubroutines[ u8Subroutine ].pu8Code + gasSubroutines[ u8Subroutine ].u16CodeSize;
+    psLayer->sTrack.u8NumValues = u8NumValues;
+    RewindTrack( &psLayer->sTrack );
+  }
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Executes the instructions of the layers
+//! \param  -
+//! \return -
+//! \global gasLayers[], gbitLEDsChanged, gbitRGBChanged
+//! \note   Each layer restarts at the end of its subroutine, independently of the tracks.
+//!         The timers are advanced by Animation_Cycle() before the tracks run, a layer started in this cycle is at 0.
+//-----------------------------------------------------------------------------
+static void RunLayers( void )
+{
+  const S_ANIMATION_INSTRUCTION* psInstruction;
+  S_ANIMATION_LAYER* psLayer;
+  U16 u16State;
+  BOOL bChanged;
+  U8 u8Layer;
+  
+  for( u8Layer = 0u; u8Layer < ANIMATION_LAYERS; u8Layer++ )
+  {
+    psLayer = &gasLayers[ u8Layer ];
+    if( LAYER_FREE != psLayer->u8Subroutine )
+    {
+      bChanged = FALSE;
+      psInstruction = SeekInstruction( &psLayer->sTrack, psLayer->u32Timer, &u16State );
+      if( NULL == psInstruction )  // restart the layer
+      {
+        psLayer->u32Timer = 0u;
+        psInstruction = SeekInstruction( &psLayer->sTrack, psLayer->u32Timer, &u16State );
+      }
+      if( ( NULL != psInstruction ) && ( psLayer->sChannel.u16LastState != u16State ) )  // next instruction
+      {
+        bChanged = TRUE;
+        ExecuteInstruction( &psLayer->sChannel, psInstruction, u16State );
+      }
+      if( UpdateFade( &psLayer->sChannel ) )
+      {
+        bChanged = TRUE;
+      }
+      if( bChanged && ( LEDS_NUM == psLayer->sChannel.u8NumValues ) )
+      {
+        gbitLEDsChanged = TRUE;
+      }
+      else if( bChanged )
+      {
+        gbitRGBChanged = TRUE;
+      }
+    }
+  }
+}
+#endif
+
+//----------------------------------------------------------------------------
+//! \brief  Steps the random generator of an output
+//! \param  *psChannel: the virtual machine of the output
+//! \return Random byte
+//! \global -
+//-----------------------------------------------------------------------------
+static U8 NextRandom( S_ANIMATION_CHANNEL* psChannel )
+{
+  U8 u8Index;
+  
+  // One step gives one bit only, a byte needs 8
+  for( u8Index = 0u; u8Index < 8u; u8Index++ )
+  {
+    if( 0u != ( psChannel->u16Random & 1u ) )
+    {
+      psChannel->u16Random = ( psChannel->u16Random >> 1u ) ^ LFSR_TAPS;
+    }
+    else
+    {
+      psChannel->u16Random >>= 1u;
+    }
+  }
+  return (U8)psChannel->u16Random;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Computes the levels of an output with the generator of an instruction
+//! \param  *psChannel: the virtual machine of the output
+//! \param  *psInstruction: the GENERATE instruction
+//! \return -
+//! \global gau8SineHalfWave[]
+//! \note   Random numbers and fade rates are scaled by multiplication, there's no division.
+//-----------------------------------------------------------------------------
+static void Generate( S_ANIMATION_CHANNEL* psChannel, const S_ANIMATION_INSTRUCTION* psInstruction )
+{
+  U8* pu8Levels = psChannel->pu8Levels;
+  U8  u8Parameter = psInstruction->u8GeneratorParameter;
+  U8  u8Index;
+  U8  u8Value;
+  U8  u8Position;
+  
+  if( ( GENERATOR_FADE == psInstruction->u8Generator ) && ( 0u != psInstruction->u32Timing ) )
+  {
+    memcpy( psChannel->au8FadeFrom, pu8Levels, psChannel->u8NumValues );
+    psChannel->u32FadeStart = *psChannel->pu32Timer;
+    psChannel->u32FadeDuration = psInstruction->u32Timing;
+    psChannel->u32FadeRate = FadeRate( psInstruction->u32Timing );
+    psChannel->u16FadeProgress = 0u;
+    psChannel->u8FadeEasing = u8Parameter;
+  }
+  for( u8Index = 0u; u8Index < psChannel->u8NumValues; u8Index++ )
+  {
+    u8Value = (U8)psInstruction->ai8Values[ u8Index ];
+    switch( psInstruction->u8Generator )
+    {
+      case GENERATOR_NOISE:     // Random level in [0; value]
+        u8Value = (U8)( ( ( NextRandom( psChannel ) & 0x0Fu ) * ( u8Value + 1u ) ) >> 4u );
+        break;
+      
+      case GENERATOR_FLICKER:   // Value darkened by [0; parameter]
+        u8Position = (U8)( ( ( NextRandom( psChannel ) & 0x0Fu ) * ( u8Parameter + 1u ) ) >> 4u );
+        u8Value = ( u8Value > u8Position ) ? (U8)( u8Value - u8Position ) : 0u;
+        break;
+      
+      case GENERATOR_SINE:      // Wave, the value is the phase offset
+      case GENERATOR_TRIANGLE:
+        u8Position = (U8)( psChannel->u8Phase + ( u8Value << 4u ) ) >> 3u;  // [0; 31]
+        if( u8Position > ANIMATION_LEVEL_MAX )  // second half of the period is the mirror of the first
         {
-          // Left side
-          for( u8Index = (RIGHT_LEDS_START - 1u); u8Index > 0u; u8Index-- )
-          {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ u8Index ];
-            gau8LEDBrightness[ u8Index ] += i8Change;
-            for( u8InnerIndex = u8Index; u8InnerIndex > 0u; u8InnerIndex-- )
-            {
-              gau8LEDBrightness[ u8InnerIndex - 1u ] += SaturateBrightness( &gau8LEDBrightness[ u8InnerIndex ] );
-            }
-          }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ 0u ];
-          gau8LEDBrightness[ 0u ] += i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ 0u ] );
-          // Right side
-          for( u8Index = RIGHT_LEDS_START; u8Index < (LEDS_NUM - 1u); u8Index++ )
-          {
-            i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ u8Index ];
-            gau8LEDBrightness[ u8Index ] += i8Change;
-            for( u8InnerIndex = RIGHT_LEDS_START; u8InnerIndex < (LEDS_NUM - 1u); u8InnerIndex++ )
-            {
-              gau8LEDBrightness[ u8InnerIndex + 1u ] += SaturateBrightness( &gau8LEDBrightness[ u8InnerIndex ] );
-            }
-          }
-          i8Change = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ LEDS_NUM - 1u ];
-          gau8LEDBrightness[ LEDS_NUM - 1u ] += i8Change;
-          SaturateBrightness( &gau8LEDBrightness[ LEDS_NUM - 1u ] );
+          u8Position = 31u - u8Position;
         }
-        // Divide instruction
-        if( DIV & u8OpCode )
+        if( GENERATOR_SINE == psInstruction->u8Generator )
         {
-          for( u8Index = 0u; u8Index < LEDS_NUM; u8Index++ )
-          {
-            u8Temp = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].ai8LEDBrightness[ u8Index ];
-            if( u8Temp != 0u )
-            {
-              gau8LEDBrightness[ u8Index ] /= u8Temp;
-            }
-          }
+          u8Value = gau8SineHalfWave[ u8Position ];
         }
-        // Repeat instruction
-        if( REPEAT & u8OpCode )
+        else
         {
-          // If we're here the first time
-          if( 0u == u8RepetitionCounter )
-          {
-            u8RepetitionCounter = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].u8AnimationOperand;
-            // Step back in time
-            gu16NormalTimer -= gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].u16TimingMs;
-          }
-          else  // We're already repeating...
-          {
-            u8RepetitionCounter--;
-            if( 0u != u8RepetitionCounter )
-            {
-              // Step back in time
-              gu16NormalTimer -= gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsNormal[ u8AnimationState ].u16TimingMs;
-            }
-            else  // No more repeating
-            {
-             u8LastState = u8AnimationState;
-            }
-          }
+          u8Value = u8Position;
         }
-        else  // if there's no repeat opcode
+        break;
+      
+      default:                  // GENERATOR_SPARKLE and GENERATOR_FADE, the values are kept
+        break;
+    }
+    pu8Levels[ u8Index ] = u8Value;
+  }
+  if( GENERATOR_SPARKLE == psInstruction->u8Generator )
+  {
+    pu8Levels[ ( (U16)NextRandom( psChannel ) * psChannel->u8NumValues ) >> 8u ] = u8Parameter;
+  }
+  else if( GENERATOR_FADE != psInstruction->u8Generator )
+  {
+    psChannel->u8Phase += u8Parameter;  // used by the waves only
+  }
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Executes an instruction on the levels of an output
+//! \param  *psChannel: the virtual machine of the output
+//! \param  *psInstruction: the instruction
+//! \param  u16State: index of the instruction
+//! \return -
+//! \global gau8Reciprocals[]
+//! \note   The same opcodes work on the normal LEDs and on the colors of the RGB LED.
+//-----------------------------------------------------------------------------
+static void ExecuteInstruction( S_ANIMATION_CHANNEL* psChannel, const S_ANIMATION_INSTRUCTION* psInstruction, U16 u16State )
+{
+  U8* pu8Levels = psChannel->pu8Levels;
+  U8  u8Num = psChannel->u8NumValues;
+  U8  u8Right = psChannel->u8RightStart;
+  U8  u8Index;
+  U8  u8OpCode = psInstruction->u8AnimationOpcode;
+  U8  u8Temp;
+  
+  psChannel->u32FadeDuration = 0u;  // a new instruction ends the running fade
+  // Just a load instruction, nothing more
+  if( LOAD == u8OpCode )
+  {
+    memcpy( pu8Levels, (void*)psInstruction->ai8Values, u8Num );
+    psChannel->u16LastState = u16State;
+  }
+  else  // Other opcodes -- IMPORTANT: the order of operations are fixed!
+  {
+    // Generator
+    if( GENERATE & u8OpCode )
+    {
+      Generate( psChannel, psInstruction );
+    }
+    // Add operation
+    if( ADD & u8OpCode )
+    {
+      for( u8Index = 0u; u8Index < u8Num; u8Index++ )
+      {
+        pu8Levels[ u8Index ] += psInstruction->ai8Values[ u8Index ];
+        if( pu8Levels[ u8Index ] > ANIMATION_LEVEL_MAX )  // overflow/underflow happened
         {
-          u8LastState = u8AnimationState;  // save that this operation is finished
+          pu8Levels[ u8Index ] = 0u;
         }
       }
     }
-    
-    // --------------------------------------< For the RGB LED
-    // Calculate the state of the animation
-    u16StateTimer = 0u;
-    for( u8AnimationState = 0u; u8AnimationState < gasAnimations[ gsPersistentData.u8AnimationIndex ].u8AnimationLengthRGB; u8AnimationState++ )
+    // Right shift operation
+    if( RSHIFT & u8OpCode )
     {
-      u16StateTimer += gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].u16TimingMs;
-      if( u16StateTimer > gu16RGBTimer )
+      u8Temp = pu8Levels[ u8Num - 1u ];
+      for( u8Index = u8Num - 1u; u8Index > 0u; u8Index-- )
       {
-        break;
+        pu8Levels[ u8Index ] = pu8Levels[ u8Index - 1u ];
       }
+      pu8Levels[ 0u ] = u8Temp;
     }
-/*
-    if( u8AnimationState >= gasAnimations[ gsPersistentData.u8AnimationIndex ].u8AnimationLengthRGB )
+    // Left shift operation
+    if( LSHIFT & u8OpCode )
     {
-      // restart animation
-      u8AnimationState = 0u;
-      DISABLE_IT;
-      gu16SynchronizedTimer = 0;
-      ENABLE_IT;
+      u8Temp = pu8Levels[ 0u ];
+      for( u8Index = 0u; u8Index < (u8Num - 1u); u8Index++ )
+      {
+        pu8Levels[ u8Index ] = pu8Levels[ u8Index + 1u ];
+      }
+      pu8Levels[ u8Num - 1u ] = u8Temp;
     }
-*/
-    if( u8LastStateRGB != u8AnimationState )  // next instruction
+    // Upward source instruction: the left side flows up from the bottom, the right side down from the top
+    if( USOURCE & u8OpCode )
     {
-      u8OpCode = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].u8AnimationOpcode;
-      // Just a load instruction, nothing more
-      if( LOAD == u8OpCode )
+      FlowSource( pu8Levels, psInstruction->ai8Values, 0u, u8Right - 1u );
+      if( u8Right < u8Num )
       {
-        memcpy( (U8*)gau8RGBLEDs, (void*)gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].ai8RGBLEDBrightness, NUM_RGBLED_COLORS );
-        u8LastStateRGB = u8AnimationState;
+        FlowSource( pu8Levels, psInstruction->ai8Values, u8Num - 1u, u8Right );
       }
-      else  // Other opcodes -- IMPORTANT: the order of operations are fixed!
+    }
+    // Downward source instruction: the opposite directions
+    if( DSOURCE & u8OpCode )
+    {
+      FlowSource( pu8Levels, psInstruction->ai8Values, u8Right - 1u, 0u );
+      if( u8Right < u8Num )
       {
-        // Add operation
-        if( ADD & u8OpCode )
-        {
-          for( u8Index = 0u; u8Index < NUM_RGBLED_COLORS; u8Index++ )
-          {
-            gau8RGBLEDs[ u8Index ] += gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].ai8RGBLEDBrightness[ u8Index ];
-            if( gau8RGBLEDs[ u8Index ] > 15u )  // overflow/underflow happened
-            {
-              gau8RGBLEDs[ u8Index ] = 0u;
-            }
-          }
-        }
-        // Right shift operation
-        if( RSHIFT & u8OpCode )
-        {
-          // Not implemented
-        }
-        // Left shift operation
-        if( LSHIFT & u8OpCode )
-        {
-          // Not implemented
-        }
-/*
-        // Upward move operation
-        if( UMOVE & u8OpCode )
-        {
-          // Not implemented
-        }
-        // Downward move operation
-        if( DMOVE & u8OpCode )
-        {
-          // Not implemented
-        }
-*/
-        if( USOURCE & u8OpCode )
-        {
-          // Not implemented
-        }
-        if( DSOURCE & u8OpCode )
+        FlowSource( pu8Levels, psInstruction->ai8Values, u8Right, u8Num - 1u );
+      }
+    }
+    // Divide instruction
+    if( DIV & u8OpCode )
+    {
+      for( u8Index = 0u; u8Index < u8Num; u8Index++ )
+      {
+        u8Temp = psInstruction->ai8Values[ u8Index ];
+        if( u8Temp > ANIMATION_LEVEL_MAX )  // includes the negative divisors, the quotient is always 0
         {
-          // Not implemented
+          pu8Levels[ u8Index ] = 0u;
         }
-        if( DIV & u8OpCode )
+        else if( u8Temp > 1u )  // no runtime division, the core has no divider
         {
-          for( u8Index = 0u; u8Index < NUM_RGBLED_COLORS; u8Index++ )
-          {
-            u8Temp = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].ai8RGBLEDBrightness[ u8Index ];
-            if( u8Temp != 0u )
-            {
-              gau8RGBLEDs[ u8Index ] /= u8Temp;
-            }
-          }
+          pu8Levels[ u8Index ] = (U8)( ( (U16)pu8Levels[ u8Index ] * gau8Reciprocals[ u8Temp ] ) >> 8u );
         }
-        // Repeat instruction
-        if( REPEAT & u8OpCode )
+      }
+    }
+    // Repeat instruction
+    if( REPEAT & u8OpCode )
+    {
+      // If we're here the first time
+      if( 0u == psChannel->u8RepetitionCounter )
+      {
+        psChannel->u8RepetitionCounter = psInstruction->u8AnimationOperand;
+        // Step back in time
+        *psChannel->pu32Timer -= psInstruction->u32Timing;
+      }
+      else  // We're already repeating...
+      {
+        psChannel->u8RepetitionCounter--;
+        if( 0u != psChannel->u8RepetitionCounter )
         {
-          // If we're here the first time
-          if( 0u == u8RepetitionCounterRGB )
-          {
-            u8RepetitionCounterRGB = gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].u8AnimationOperand;
-            // Step back in time
-            gu16RGBTimer -= gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].u16TimingMs;
-          }
-          else  // We're already repeating...
-          {
-            u8RepetitionCounterRGB--;
-            if( 0u != u8RepetitionCounterRGB )
-            {
-              // Step back in time
-              gu16RGBTimer -= gasAnimations[ gsPersistentData.u8AnimationIndex ].psInstructionsRGB[ u8AnimationState ].u16TimingMs;
-            }
-            else  // No more repeating
-            {
-             u8LastStateRGB = u8AnimationState;
-            }
-          }
+          // Step back in time
+          *psChannel->pu32Timer -= psInstruction->u32Timing;
         }
-        else  // if there's no repeat opcode
+        else  // No more repeating
         {
-          u8LastStateRGB = u8AnimationState;  // save that this operation is finished
+          psChannel->u16LastState = u16State;
         }
       }
-    }    
+    }
+    else  // if there's no repeat opcode
+    {
+      psChannel->u16LastState = u16State;  // save that this operation is finished
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Restarts the animation machines with the given animation
+//! \param  u8AnimationIndex: the new animation [0; NUM_ANIMATIONS)
+//! \return -
+//! \global gsPersistentData, gu32NormalTimer, gu32RGBTimer, gsChannelNormal, gsChannelRGB,
+//!         gau8CrossfadeLEDs[], gau8CrossfadeRGB[], gu16CrossfadeElapsed
+//-----------------------------------------------------------------------------
+static void SwitchAnimation( U8 u8AnimationIndex )
+{
+  gsPersistentData.u8AnimationIndex = u8AnimationIndex;
+  gu32NormalTimer = 0u;
+  gu32RGBTimer = 0u;
+  gsChannelNormal.u16LastState = STATE_NONE;
+  gsChannelNormal.u8RepetitionCounter = 0u;
+  gsChannelNormal.u8Phase = 0u;
+  gsChannelNormal.u32FadeDuration = 0u;
+  gsChannelRGB.u16LastState = STATE_NONE;
+  gsChannelRGB.u8RepetitionCounter = 0u;
+  gsChannelRGB.u8Phase = 0u;
+  gsChannelRGB.u32FadeDuration = 0u;
+#ifdef ANIMATION_CROSSFADE_MS
+  // The outgoing animation is the one on the LEDs, even if a crossfade was running already
+  memcpy( gau8CrossfadeLEDs, gau8LEDBrightness, LEDS_NUM );
+  memcpy( gau8CrossfadeRGB, (const U8*)gau8RGBLEDs, NUM_RGBLED_COLORS );
+  gu16CrossfadeElapsed = 0u;
+#endif
+  LoadProgram();
+}
+
+#ifdef ANIMATION_IN_PENDSV
+//----------------------------------------------------------------------------
+//! \brief  Calculates the time until the next instruction of a track
+//! \param  *psTrack: the track
+//! \param  u32Timer: animation timer of the track
+//! \return VM_TIME() units, 0 if the decoding is behind the timer, WAKEUP_NEVER if the track is over
+//! \global -
+//-----------------------------------------------------------------------------
+static U32 TimeToNextInstruction( const S_ANIMATION_TRACK* psTrack, U32 u32Timer )
+{
+  U32 u32Return = 0u;
+  
+  if( u32Timer < psTrack->u32WindowStart )  // stepped back beyond the window, the track is rewound in the next cycle
+  {
+    u32Return = 0u;
+  }
+  else if( u32Timer < psTrack->au32Deadline[ 1u - psTrack->u8Newest ] )
+  {
+    u32Return = psTrack->au32Deadline[ 1u - psTrack->u8Newest ] - u32Timer;
+  }
+  else if( u32Timer < psTrack->au32Deadline[ psTrack->u8Newest ] )
+  {
+    u32Return = psTrack->au32Deadline[ psTrack->u8Newest ] - u32Timer;
+  }
+  else if( psTrack->pu8Next == psTrack->pu8BlockEnd )
+  {
+    u32Return = WAKEUP_NEVER;
+  }
+  return u32Return;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Schedules the next cycle to the first instruction deadline of the tracks and the layers
+//! \param  -
+//! \return -
+//! \global gu16Wakeup, gbitWakeupScheduled, gu16LastCall, gsTrackNormal, gsTrackRGB, gsChannelNormal, gsChannelRGB,
+//!         gbitLEDsChanged, gbitRGBChanged, gu16CrossfadeElapsed, gasLayers[], gu8RequestedAnimation
+//! \note   A running fade or crossfade, a commit refused by a driver and a pending switch need a cycle in every frame.
+//-----------------------------------------------------------------------------
+static void ScheduleWakeup( void )
+{
+  U32 u32Delay = WAKEUP_MAX;
+  U32 u32Time;
+#ifdef ANIMATION_LAYERS
+  U8  u8Layer;
+#endif
+  
+  if( gbitLEDsChanged || gbitRGBChanged || ( 0u != gsChannelNormal.u32FadeDuration ) || ( 0u != gsChannelRGB.u32FadeDuration ) ||
+      ( PROGRAM_NONE != gu8RequestedAnimation ) )
+  {
+    u32Delay = 0u;
+  }
+#ifdef ANIMATION_CROSSFADE_MS
+  if( gu16CrossfadeElapsed < VM_TIME( ANIMATION_CROSSFADE_MS ) )
+  {
+    u32Delay = 0u;
+  }
+#endif
+  u32Time = TimeToNextInstruction( &gsTrackNormal, gu32NormalTimer );
+  if( u32Time < u32Delay )
+  {
+    u32Delay = u32Time;
+  }
+  u32Time = TimeToNextInstruction( &gsTrackRGB, gu32RGBTimer );
+  if( u32Time < u32Delay )
+  {
+    u32Delay = u32Time;
+  }
+#ifdef ANIMATION_LAYERS
+  for( u8Layer = 0u; u8Layer < ANIMATION_LAYERS; u8Layer++ )
+  {
+    if( LAYER_FREE != gasLayers[ u8Layer ].u8Subroutine )
+    {
+      if( 0u != gasLayers[ u8Layer ].sChannel.u32FadeDuration )
+      {
+        u32Delay = 0u;
+      }
+      u32Time = TimeToNextInstruction( &gasLayers[ u8Layer ].sTrack, gasLayers[ u8Layer ].u32Timer );
+      if( u32Time < u32Delay )
+      {
+        u32Delay = u32Time;
+      }
+    }
+  }
+#endif
+  gu16Wakeup = gu16LastCall + (U16)u32Delay;
+  gbitWakeupScheduled = TRUE;
+}
+#endif
+
+
+/***************************************< Public functions >**************************************/
+//----------------------------------------------------------------------------
+//! \brief  Initialize layer
+//! \param  -
+//! \return -
+//! \global All globals in this layer.
+//! \note   Should be called in the init block of the firmware.
+//-----------------------------------------------------------------------------
+void Animation_Init( void )
+{
+  gu32NormalTimer = 0u;
+  gu32RGBTimer = 0u;
+  gu16LastCall = VM_TIMER();
+  gu8ProgramIndex = PROGRAM_NONE;
+#ifdef ANIMATION_CROSSFADE_MS
+  gu16CrossfadeElapsed = 0u;  // fade in from the dark LEDs, the first frame may be a full bright one
+#endif
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Check timer and update LED brightnesses based on the animation.
+//! \param  -
+//! \return -
+//! \global -
+//! \note   Should be called from main cycle. With ANIMATION_IN_PENDSV it's called once from the main program,
+//!         then from the PendSV handler, which is pended by Animation_FrameInterrupt() when the next cycle is due.
+//-----------------------------------------------------------------------------
+void Animation_Cycle( void )
+{
+  const S_ANIMATION_INSTRUCTION* psInstruction;
+  const S_ANIMATION_INSTRUCTION* psInstructionRGB;
+  U16 u16AnimationState;
+  U16 u16TimeNow = VM_TIMER();
+  U16 u16Elapsed = u16TimeNow - gu16LastCall;  // wraps together with the timer
+#ifdef ANIMATION_LAYERS
+  U8  u8Layer;
+#endif
+  
+  // Check if time has elapsed since last call
+  if( 0u != u16Elapsed )
+  {
+    // Increase the synchronized timer with the difference
+    gu32NormalTimer += u16Elapsed;
+    gu32RGBTimer += u16Elapsed;
+#ifdef ANIMATION_LAYERS
+    for( u8Layer = 0u; u8Layer < ANIMATION_LAYERS; u8Layer++ )
+    {
+      gasLayers[ u8Layer ].u32Timer += u16Elapsed;
+    }
+#endif
+#ifdef ANIMATION_CROSSFADE_MS
+    // The blend changes in every time unit, the last step publishes the incoming animation alone
+    if( gu16CrossfadeElapsed < VM_TIME( ANIMATION_CROSSFADE_MS ) )
+    {
+      if( u16Elapsed < ( VM_TIME( ANIMATION_CROSSFADE_MS ) - gu16CrossfadeElapsed ) )
+      {
+        gu16CrossfadeElapsed += u16Elapsed;
+      }
+      else
+      {
+        gu16CrossfadeElapsed = VM_TIME( ANIMATION_CROSSFADE_MS );
+      }
+      gbitLEDsChanged = TRUE;
+      gbitRGBChanged = TRUE;
+    }
+#endif
+#ifdef ANIMATION_IN_PENDSV
+    // The time since the previous cycle belongs to the outgoing animation, the LEDs were showing it
+    if( PROGRAM_NONE != gu8RequestedAnimation )
+    {
+      SwitchAnimation( gu8RequestedAnimation );
+      gu8RequestedAnimation = PROGRAM_NONE;
+    }
+#endif
+
+    // Make sure not to overindex arrays
+    if( gsPersistentData.u8AnimationIndex >= NUM_ANIMATIONS )
+    {
+      gsPersistentData.u8AnimationIndex = 0u;
+    }
+    // The index may have been changed without Animation_Set(), e.g. when it was restored from the flash
+    if( gu8ProgramIndex != gsPersistentData.u8AnimationIndex )
+    {
+      LoadProgram();
+    }
+    
+    // --------------------------------------< For the normal LEDs
+    // Calculate the state of the animation
+    psInstruction = SeekInstruction( &gsTrackNormal, gu32NormalTimer, &u16AnimationState );
+    if( NULL == psInstruction )
+    {
+      // restart animation
+      gu32NormalTimer = 0u;
+      gu32RGBTimer = 0u;
+      psInstruction = SeekInstruction( &gsTrackNormal, gu32NormalTimer, &u16AnimationState );
+    }
+    if( ( NULL != psInstruction ) && ( gsChannelNormal.u16LastState != u16AnimationState ) )  // next instruction
+    {
+      gbitLEDsChanged = TRUE;
+      ExecuteInstruction( &gsChannelNormal, psInstruction, u16AnimationState );
+    }
+    
+    // --------------------------------------< For the RGB LED
+    // Calculate the state of the animation, the RGB LED is restarted with the normal LEDs
+    psInstructionRGB = SeekInstruction( &gsTrackRGB, gu32RGBTimer, &u16AnimationState );
+    if( ( NULL != psInstructionRGB ) && ( gsChannelRGB.u16LastState != u16AnimationState ) )  // next instruction
+    {
+      gbitRGBChanged = TRUE;
+      ExecuteInstruction( &gsChannelRGB, psInstructionRGB, u16AnimationState );
+    }
+    
+    // --------------------------------------< Fades run between the instructions
+    if( UpdateFade( &gsChannelNormal ) )
+    {
+      gbitLEDsChanged = TRUE;
+    }
+    if( UpdateFade( &gsChannelRGB ) )
+    {
+      gbitRGBChanged = TRUE;
+    }
+#ifdef ANIMATION_LAYERS
+    RunLayers();
+#endif
+    PublishLevels();
     // Store the timestamp
     gu16LastCall = u16TimeNow;
   }
+#ifdef ANIMATION_IN_PENDSV
+  ScheduleWakeup();
+#endif
 }
 
 //----------------------------------------------------------------------------
 //! \brief  Set the new animation
-//! \param  -
+//! \param  u8AnimationIndex: the new animation [0; NUM_ANIMATIONS)
 //! \return -
-//! \global -
+//! \global gu8RequestedAnimation, gsPersistentData
 //! \note   Should be called from main cycle only!
+//!         With ANIMATION_IN_PENDSV the VM is restarted by a cycle in the PendSV handler, so it doesn't race with
+//!         the running animation. That cycle may be a frame later if no time has elapsed since the previous one,
+//!         so the selection is stored here already, a Persist_Save() right after this call saves the new one.
 //-----------------------------------------------------------------------------
 void Animation_Set( U8 u8AnimationIndex )
 {
   if( u8AnimationIndex < NUM_ANIMATIONS )
   {
+#ifdef ANIMATION_IN_PENDSV
+    gu8RequestedAnimation = u8AnimationIndex;  // first, so a cycle preempting us never reloads the program without a restart
     gsPersistentData.u8AnimationIndex = u8AnimationIndex;
-    DISABLE_IT;
-    gu16NormalTimer = 0u;
-    gu16RGBTimer = 0u;
-    ENABLE_IT;
-    u8LastState = 0xFFu;
-    u8RepetitionCounter = 0u;
-    u8LastStateRGB = 0xFFu;
-    u8RepetitionCounterRGB = 0u;
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+#else
+    SwitchAnimation( u8AnimationIndex );
+#endif
   }
 }
 
+#ifdef ANIMATION_IN_PENDSV
+//----------------------------------------------------------------------------
+//! \brief  Pends the next cycle of the animations if it's due
+//! \param  -
+//! \return -
+//! \global gu16Wakeup, gbitWakeupScheduled
+//! \note   Called from the LED driver interrupt at PWM frame boundaries, after the committed frame is taken over.
+//!         The cycle runs in the PendSV handler with the lowest priority, so the drivers preempt it.
+//-----------------------------------------------------------------------------
+void Animation_FrameInterrupt( void )
+{
+  if( gbitWakeupScheduled && ( (I16)( VM_TIMER_ISR() - gu16Wakeup ) >= 0 ) )
+  {
+    gbitWakeupScheduled = FALSE;
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+  }
+}
+#endif
+
 
 /***************************************< End of file >**************************************/
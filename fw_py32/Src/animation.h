@@ -54,6 +54,9 @@
 void Animation_Init( void );
 void Animation_Cycle( void );
 void Animation_Set( U8 u8AnimationIndex );
+#ifdef ANIMATION_IN_PENDSV
+void Animation_FrameInterrupt( void );
+#endif
 
 
 #endif /* ANIMATION_H */
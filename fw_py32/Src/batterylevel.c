@@ -21,12 +21,47 @@
 
 
 /***************************************< Definitions >**************************************/
+//! \brief Highest ADC reading of the internal reference that still means the given charge level
+//! \note  Derived from u8ChargeLevel = ( ( u32Scale / u16MeasuredLevel ) - u8Offset ) >> u8Shift, evaluated by the compiler
+#define CHARGE_THRESHOLD( u32Scale, u8Offset, u8Shift, u8Level )  \
+  ( (U16)( (u32Scale) / ( ( (U32)(u8Level) << (u8Shift) ) + (u8Offset) ) ) )
 
 
 /***************************************< Types >**************************************/
 
 
 /***************************************< Constants >**************************************/
+//! \brief Charge level thresholds in descending order, the charge level is the number of thresholds not below the measurement
+//! \note  The core has no hardware divider, so the charge level formulas are evaluated here at compile time
+#if defined( KARIFA ) || defined( RUDOLF ) || defined( HOEMBER )
+#define CHARGE_LEVELS_NUM  ( LEDS_NUM/2u + 1u )  //!< 6 + 1 LED levels
+CODE const U16 gau16ChargeThresholds[ CHARGE_LEVELS_NUM ] =
+{
+  CHARGE_THRESHOLD( 170600u, 70u, 2u, 1u ), CHARGE_THRESHOLD( 170600u, 70u, 2u, 2u ), CHARGE_THRESHOLD( 170600u, 70u, 2u, 3u ),
+  CHARGE_THRESHOLD( 170600u, 70u, 2u, 4u ), CHARGE_THRESHOLD( 170600u, 70u, 2u, 5u ), CHARGE_THRESHOLD( 170600u, 70u, 2u, 6u ),
+  CHARGE_THRESHOLD( 170600u, 70u, 2u, 7u )
+};
+#endif
+#ifdef HOPEHELY
+#define CHARGE_LEVELS_NUM  ( LEDS_NUM + 1u )  //!< 12 + 1 LED levels
+CODE const U16 gau16ChargeThresholds[ CHARGE_LEVELS_NUM ] =
+{
+  CHARGE_THRESHOLD( 159744u, 65u, 1u,  1u ), CHARGE_THRESHOLD( 159744u, 65u, 1u,  2u ), CHARGE_THRESHOLD( 159744u, 65u, 1u,  3u ),
+  CHARGE_THRESHOLD( 159744u, 65u, 1u,  4u ), CHARGE_THRESHOLD( 159744u, 65u, 1u,  5u ), CHARGE_THRESHOLD( 159744u, 65u, 1u,  6u ),
+  CHARGE_THRESHOLD( 159744u, 65u, 1u,  7u ), CHARGE_THRESHOLD( 159744u, 65u, 1u,  8u ), CHARGE_THRESHOLD( 159744u, 65u, 1u,  9u ),
+  CHARGE_THRESHOLD( 159744u, 65u, 1u, 10u ), CHARGE_THRESHOLD( 159744u, 65u, 1u, 11u ), CHARGE_THRESHOLD( 159744u, 65u, 1u, 12u ),
+  CHARGE_THRESHOLD( 159744u, 65u, 1u, 13u )
+};
+#endif
+#if defined( MEZI ) || defined( AJANDEKCSOMAG )
+#define CHARGE_LEVELS_NUM  ( LEDS_NUM/2u + 1u )  //!< 6 LED levels, MEZI shows one more on its top LEDs
+CODE const U16 gau16ChargeThresholds[ CHARGE_LEVELS_NUM ] =
+{
+  CHARGE_THRESHOLD( 36864u, 15u, 0u, 1u ), CHARGE_THRESHOLD( 36864u, 15u, 0u, 2u ), CHARGE_THRESHOLD( 36864u, 15u, 0u, 3u ),
+  CHARGE_THRESHOLD( 36864u, 15u, 0u, 4u ), CHARGE_THRESHOLD( 36864u, 15u, 0u, 5u ), CHARGE_THRESHOLD( 36864u, 15u, 0u, 6u ),
+  CHARGE_THRESHOLD( 36864u, 15u, 0u, 7u )
+};
+#endif
 
 
 /***************************************< Global variables >**************************************/
@@ -34,20 +69,54 @@
 
 /***************************************< Static function definitions >**************************************/
 void Delay( U16 u16DelayMs );
+static U8 ChargeLevel( U16 u16MeasuredLevel );
 
 
 /***************************************< Private functions >**************************************/
 //----------------------------------------------------------------------------
-//! \brief  Waits for the given number of milliseconds
+//! \brief  Shows the brightness levels set so far and waits for the given number of milliseconds
 //! \param  u16DelayMs: wait time
 //! \return -
-//! \global -
+//! \global gau8LEDBrightness[], gau8RGBLEDs[]
 //! \note   Should be called from init block
 //-----------------------------------------------------------------------------
 void Delay( U16 u16DelayMs )
 {
-  U16 u16DelayEnd = Util_GetTimerMs() + u16DelayMs;
-  while( Util_GetTimerMs() < u16DelayEnd );
+  U16  u16DelayEnd = Util_GetTimerMs() + u16DelayMs;
+  BOOL bLEDsCommitted = FALSE;
+  BOOL bRGBCommitted = FALSE;
+  
+  while( Util_GetTimerMs() < u16DelayEnd )
+  {
+    // Retry until the drivers have taken the previous frame
+    if( !bLEDsCommitted )
+    {
+      bLEDsCommitted = LED_Commit();
+    }
+    if( !bRGBCommitted )
+    {
+      bRGBCommitted = RGBLED_Commit();
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Converts the measured level of the internal reference to charge level
+//! \param  u16MeasuredLevel: ADC reading of the 1.2 V internal reference
+//! \return Charge level [0; CHARGE_LEVELS_NUM]
+//! \global gau16ChargeThresholds[]
+//! \note   At most CHARGE_LEVELS_NUM comparisons instead of a software division.
+//-----------------------------------------------------------------------------
+static U8 ChargeLevel( U16 u16MeasuredLevel )
+{
+  U8 u8Level = 0u;
+  
+  while( ( u8Level < CHARGE_LEVELS_NUM ) && ( u16MeasuredLevel <= gau16ChargeThresholds[ u8Level ] ) )
+  {
+    u8Level++;
+  }
+  
+  return u8Level;
 }
 
 
@@ -103,45 +172,45 @@ void BatteryLevel_Show( void )
 #if defined( KARIFA ) || defined( RUDOLF )
   for( u8Index = 0u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
-    gau8LEDBrightness[ u8Index ] = 15u;
-    gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = 15u;
+    gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
+    gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = LED_BRIGHTNESS_MAX;
     Delay( 100u );
   }
 #endif
 #ifdef HOEMBER
   for( u8Index = 0u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
-    gau8LEDBrightness[ u8Index ] = 15u;
-    gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = 15u;
+    gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
+    gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = LED_BRIGHTNESS_MAX;
     Delay( 100u );
   }
 #endif
 #ifdef HOPEHELY
   for( u8Index = 0u; u8Index < LEDS_NUM; u8Index++ )
   {
-    gau8LEDBrightness[ u8Index ] = 15u;
+    gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
     Delay( 50u );
   }
 #endif
 #ifdef MEZI
   for( u8Index = 0u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
-    gau8LEDBrightness[ 2u*u8Index    ] = 15u;
-    gau8LEDBrightness[ 2u*u8Index+1u ] = 15u;
+    gau8LEDBrightness[ 2u*u8Index    ] = LED_BRIGHTNESS_MAX;
+    gau8LEDBrightness[ 2u*u8Index+1u ] = LED_BRIGHTNESS_MAX;
     Delay( 100u );
   }
 #endif
 #ifdef AJANDEKCSOMAG
   for( u8Index = 0u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
-    gau8LEDBrightness[ u8Index ] = 15u;
-    gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = 15u;
+    gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
+    gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = LED_BRIGHTNESS_MAX;
     Delay( 100u );
   }
 #endif
-  gau8RGBLEDs[ 0u ] = 15u;
-  gau8RGBLEDs[ 1u ] = 15u;
-  gau8RGBLEDs[ 2u ] = 15u;
+  gau8RGBLEDs[ 0u ] = LED_BRIGHTNESS_MAX;
+  gau8RGBLEDs[ 1u ] = LED_BRIGHTNESS_MAX;
+  gau8RGBLEDs[ 2u ] = LED_BRIGHTNESS_MAX;
   Delay( 100u );
   // Measure battery voltage
   LL_ADC_REG_StartConversion( ADC1 );  // Start (regular) conversion
@@ -164,22 +233,15 @@ void BatteryLevel_Show( void )
   // We have 6 + 1 LED levels, so we divide this range to 7 levels
   // A floating-point based implementation would be: u8ChargeLevel = round( 7.0f*( f32BatteryVoltage - 2.0f )/0.8f );
   // After simplification, the formula for charge level would be: u8ChargeLevel = round( ( 42649.6f / u16MeasuredLevel ) - 17.5f )
-  if( u16MeasuredLevel >= 2457u )  // If the voltage is below 2.0V
-  {
-    u8ChargeLevel = 0u;
-  }
-  else
-  {
-    // 
-    u8ChargeLevel = ( ( 170600u / u16MeasuredLevel ) - 70u )>>2u;
-  }
+  // Below 2.0V (u16MeasuredLevel >= 2457) every threshold is exceeded and the charge level is 0
+  u8ChargeLevel = ChargeLevel( u16MeasuredLevel );
   // Display the charge level on the LEDs
   for( u8Index = 0u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
     if( u8ChargeLevel >= u8Index )
     {
-      gau8LEDBrightness[ u8Index ] = 15u;
-      gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = 15u;
+      gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
+      gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = LED_BRIGHTNESS_MAX;
     }
     else
     {
@@ -189,7 +251,7 @@ void BatteryLevel_Show( void )
   }
   if( u8ChargeLevel > LEDS_NUM/2u )
   {
-    gau8RGBLEDs[ 0u ] = 15u;  // Light up red LED
+    gau8RGBLEDs[ 0u ] = LED_BRIGHTNESS_MAX;  // Light up red LED
     gau8RGBLEDs[ 1u ] = 0u;   // green stays dark
     gau8RGBLEDs[ 2u ] = 0u;   // blue stays dark
   }
@@ -205,22 +267,15 @@ void BatteryLevel_Show( void )
   // We have 6 + 1 LED levels, so we divide this range to 7 levels
   // A floating-point based implementation would be: u8ChargeLevel = round( 7.0f*( f32BatteryVoltage - 2.0f )/0.8f );
   // After simplification, the formula for charge level would be: u8ChargeLevel = round( ( 42649.6f / u16MeasuredLevel ) - 17.5f )
-  if( u16MeasuredLevel >= 2457u )  // If the voltage is below 2.0V
-  {
-    u8ChargeLevel = 0u;
-  }
-  else
-  {
-    // 
-    u8ChargeLevel = ( ( 170600u / u16MeasuredLevel ) - 70u )>>2u;
-  }
+  // Below 2.0V (u16MeasuredLevel >= 2457) every threshold is exceeded and the charge level is 0
+  u8ChargeLevel = ChargeLevel( u16MeasuredLevel );
   // Display the charge level on the LEDs
   for( u8Index = 0u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
     if( u8ChargeLevel >= u8Index )
     {
-      gau8LEDBrightness[ u8Index ] = 15u;
-      gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = 15u;
+      gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
+      gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = LED_BRIGHTNESS_MAX;
     }
     else
     {
@@ -230,8 +285,8 @@ void BatteryLevel_Show( void )
   }
   if( u8ChargeLevel > LEDS_NUM/2u )
   {
-    gau8RGBLEDs[ 0u ] = 15u;  // Light up red LED
-    gau8RGBLEDs[ 1u ] = 15u;  // Light up green LED too
+    gau8RGBLEDs[ 0u ] = LED_BRIGHTNESS_MAX;  // Light up red LED
+    gau8RGBLEDs[ 1u ] = LED_BRIGHTNESS_MAX;  // Light up green LED too
     gau8RGBLEDs[ 2u ] = 0u;   // blue stays dark
   }
   else
@@ -246,20 +301,14 @@ void BatteryLevel_Show( void )
   // We have 12 + 1 LED levels, so we divide this range to 13 levels
   // A floating-point based implementation would be: u8ChargeLevel = round( 13.0f*( f32BatteryVoltage - 2.0f )/0.8f );
   // After simplification, the formula for charge level would be: u8ChargeLevel = round( ( 79872.0f / u16MeasuredLevel ) - 32.5f )
-  if( u16MeasuredLevel >= 2457u )  // If the voltage is below 2.0V
-  {
-    u8ChargeLevel = 0u;
-  }
-  else
-  {
-    u8ChargeLevel = ( ( 159744u / u16MeasuredLevel ) - 65u )>>1u;
-  }
+  // Below 2.0V (u16MeasuredLevel >= 2457) every threshold is exceeded and the charge level is 0
+  u8ChargeLevel = ChargeLevel( u16MeasuredLevel );
   // Display the charge level on the LEDs
   for( u8Index = 0u; u8Index < LEDS_NUM; u8Index++ )
   {
     if( u8ChargeLevel >= u8Index )
     {
-      gau8LEDBrightness[ u8Index ] = 15u;
+      gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
     }
     else
     {
@@ -268,9 +317,9 @@ void BatteryLevel_Show( void )
   }
   if( u8ChargeLevel > LEDS_NUM )
   {
-    gau8RGBLEDs[ 0u ] = 15u;  // Light up white LED
-    gau8RGBLEDs[ 1u ] = 15u;
-    gau8RGBLEDs[ 2u ] = 15u;
+    gau8RGBLEDs[ 0u ] = LED_BRIGHTNESS_MAX;  // Light up white LED
+    gau8RGBLEDs[ 1u ] = LED_BRIGHTNESS_MAX;
+    gau8RGBLEDs[ 2u ] = LED_BRIGHTNESS_MAX;
   }
   else
   {
@@ -284,21 +333,15 @@ void BatteryLevel_Show( void )
   // We have 6 LED levels, so we divide this range to 6 levels
   // A floating-point based implementation would be: u8ChargeLevel = round( 6.0f*( f32BatteryVoltage - 2.0f )/0.8f );
   // After simplification, the formula for charge level would be: u8ChargeLevel = round( ( 36864.0f / u16MeasuredLevel ) - 15.0f )
-  if( u16MeasuredLevel >= 2457u )  // If the voltage is below 2.0V
-  {
-    u8ChargeLevel = 0u;
-  }
-  else
-  {
-    u8ChargeLevel = ( 36864u / u16MeasuredLevel ) - 15u;
-  }
+  // Below 2.0V (u16MeasuredLevel >= 2457) every threshold is exceeded and the charge level is 0
+  u8ChargeLevel = ChargeLevel( u16MeasuredLevel );
   // Display the charge level on the LEDs
   for( u8Index = 1u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
     if( u8ChargeLevel >= u8Index-1u )
     {
-      gau8LEDBrightness[ 2u*u8Index+0u ] = 15u;
-      gau8LEDBrightness[ 2u*u8Index+1u ] = 15u;
+      gau8LEDBrightness[ 2u*u8Index+0u ] = LED_BRIGHTNESS_MAX;
+      gau8LEDBrightness[ 2u*u8Index+1u ] = LED_BRIGHTNESS_MAX;
     }
     else
     {
@@ -308,8 +351,8 @@ void BatteryLevel_Show( void )
   }
   if( u8ChargeLevel > LEDS_NUM/2u )
   {
-    gau8LEDBrightness[ 0u ] = 15u;
-    gau8LEDBrightness[ 1u ] = 15u;
+    gau8LEDBrightness[ 0u ] = LED_BRIGHTNESS_MAX;
+    gau8LEDBrightness[ 1u ] = LED_BRIGHTNESS_MAX;
   }
   else
   {
@@ -322,21 +365,15 @@ void BatteryLevel_Show( void )
   // We have 6 LED levels, so we divide this range to 6 levels
   // A floating-point based implementation would be: u8ChargeLevel = round( 6.0f*( f32BatteryVoltage - 2.0f )/0.8f );
   // After simplification, the formula for charge level would be: u8ChargeLevel = round( ( 36864.0f / u16MeasuredLevel ) - 15.0f )
-  if( u16MeasuredLevel >= 2457u )  // If the voltage is below 2.0V
-  {
-    u8ChargeLevel = 0u;
-  }
-  else
-  {
-    u8ChargeLevel = ( 36864u / u16MeasuredLevel ) - 15u;
-  }
+  // Below 2.0V (u16MeasuredLevel >= 2457) every threshold is exceeded and the charge level is 0
+  u8ChargeLevel = ChargeLevel( u16MeasuredLevel );
   // Display the charge level on the LEDs
   for( u8Index = 0u; u8Index < LEDS_NUM/2u; u8Index++ )
   {
     if( u8ChargeLevel >= u8Index )
     {
-      gau8LEDBrightness[ u8Index ] = 15u;
-      gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = 15u;
+      gau8LEDBrightness[ u8Index ] = LED_BRIGHTNESS_MAX;
+      gau8LEDBrightness[ LEDS_NUM - u8Index - 1u ] = LED_BRIGHTNESS_MAX;
     }
     else
     {
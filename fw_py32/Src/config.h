@@ -23,6 +23,25 @@
 // Uncomment only for defective units
 //#define LEDS_REVERSED   //!< The LEDs are populated in reverse
 
+// LED driver mode, uncomment only one! (16-slot soft-PWM if none is selected)
+//#define LED_MODE_BCM        //!< Binary Code Modulation: 5 timer interrupts per multiplexer side instead of 16
+//#define LED_MODE_SCHEDULED  //!< TIM16 interrupts only when pins change: one per distinct brightness level
+// Uncomment to dither the LED levels over successive frames (soft-PWM and BCM modes only)
+//#define LED_DITHERING       //!< 2 extra bits of brightness resolution with a 4 frame cycle
+// Uncomment to start the LEDs at different slots of the frame (16-slot soft-PWM only)
+//#define LED_PHASE_STAGGER   //!< Flattens the peak current drawn from the coin cell
+// Uncomment to display only the lit side while the other one is dark (soft-PWM and BCM modes only)
+//#define LED_SKIP_DARK_SIDE  //!< Half the interrupts at the same brightness, but with half the levels
+
+// Comment out to switch the animations immediately
+#define ANIMATION_CROSSFADE_MS  (300u)  //!< The outgoing animation is blended into the incoming one during this time
+// Comment out to save RAM if no animation uses LAYER() or TRACK()
+#define ANIMATION_LAYERS        (1u)    //!< Number of layers and tracks that can run besides the two main tracks at once
+// Uncomment to run the animations on the 100 usec timer ticks instead of the ms timer
+//#define ANIMATION_TICK_TIMEBASE  //!< Smoother fades and TICKS() timings for strobes, the LEDs still change at PWM frame boundaries
+// Uncomment to run the animations from PendSV at PWM frame boundaries, only when an instruction is due
+//#define ANIMATION_IN_PENDSV      //!< The main loop sleeps between the housekeeping ticks instead of waking up in every timer interrupt
+
 
 #endif /* CONFIG_H */
 
@@ -14,11 +14,67 @@
 #include "main.h"
 #include "types.h"
 #include "config.h"
+#include "util.h"
 #include "led.h"
+#include "rgbled.h"
+#ifdef ANIMATION_IN_PENDSV
+#include "animation.h"
+#endif
 
 
 /***************************************< Definitions >**************************************/
-#define PWM_LEVELS      (16u)  //!< PWM levels implemented: [0; PWM_LEVELS)
+#if defined( LED_MODE_BCM ) && defined( LED_MODE_SCHEDULED )
+  #error "Select only one LED driver mode in config.h!"
+#endif
+
+#ifdef LED_MODE_SCHEDULED
+#define PWM_LEVELS       (255u)              //!< PWM levels implemented: [0; PWM_LEVELS), one TIM16 count each
+#define PWM_EVENTS       ( LEDS_NUM/2u + 1u ) //!< Frame start and one pin change per LED of a side
+#define PWM_MAX_LEVEL    PWM_LEVELS          //!< Highest brightness that can be displayed (always on)
+#define PWM_COUNT_NEVER  PWM_LEVELS          //!< Compare value beyond the autoreload value: no compare event
+#elif defined( LED_MODE_BCM )
+#define PWM_LEVELS       (16u)               //!< PWM levels implemented: [0; PWM_LEVELS)
+#define PWM_BITS         (4u)                //!< Brightness bits displayed by the BCM slots
+#define PWM_SLOTS        ( PWM_BITS + 1u )   //!< A blanking slot and one slot per brightness bit
+#define PWM_MAX_LEVEL    ( PWM_LEVELS - 1u ) //!< Highest brightness that can be displayed
+#define SLOT_IS_ON( u8Level, u8Slot )  ( ( 0u != (u8Slot) ) && ( 0u != ( (u8Level) & ( 1u << ( (u8Slot) - 1u ) ) ) ) )
+#else
+#define PWM_LEVELS       (16u)               //!< PWM levels implemented: [0; PWM_LEVELS)
+#define PWM_SLOTS        PWM_LEVELS          //!< One slot per PWM level
+#define PWM_MAX_LEVEL    PWM_LEVELS          //!< Highest brightness that can be displayed (always on)
+#define SLOT_IS_ON( u8Level, u8Slot )  ( (u8Level) > (u8Slot) )
+#endif
+
+#ifndef LED_MODE_SCHEDULED
+#define LED_DARK_TICKS   (100u)              //!< Timer ticks per interrupt while every LED is dark (10 msec)
+#endif
+
+#ifdef LED_PHASE_STAGGER
+  #if defined( LED_MODE_BCM ) || defined( LED_MODE_SCHEDULED )
+    #error "Phase staggering is implemented for the 16-slot soft-PWM only!"
+  #endif
+#define SLOT_PHASE( u8Slot, u8Offset )  ( ( (u8Slot) - (u8Offset) ) & ( PWM_SLOTS - 1u ) )  //!< Slot relative to the start of an on-window, PWM_SLOTS is a power of 2
+#endif
+
+#ifdef LED_SKIP_DARK_SIDE
+  #ifdef LED_MODE_SCHEDULED
+    #error "The compare-scheduled driver spends a single interrupt on a dark side, there's nothing to skip!"
+  #endif
+#define SLOT_TICKS( u8Ticks )  ( (U8)( (u8Ticks) << gbitSkipping ) )  //!< Slots are twice as long while a dark side is skipped
+#else
+#define SLOT_TICKS( u8Ticks )  (u8Ticks)
+#endif
+
+#ifdef LED_DITHERING
+  #ifdef LED_MODE_SCHEDULED
+    #error "The compare-scheduled driver has 8-bit levels, dithering is not supported!"
+  #endif
+#define DITHER_BITS      (2u)                            //!< Fractional level bits spread over successive frames
+#define DITHER_STEP      ( 1u << ( 8u - DITHER_BITS ) )  //!< Smallest dithered level step in 8.8 fixed point
+#endif
+
+#define LINEAR_RECIPROCAL  ( ( 0x1000u + LED_LINEAR_STEP - 1u ) / LED_LINEAR_STEP )  //!< 1 / LED_LINEAR_STEP with 12 fraction bits, rounded up so that its multiples are exact levels
+#define LINEAR_LEVEL_8_8( u8Brightness )  ( ( (U16)(u8Brightness) * LINEAR_RECIPROCAL ) >> 4u )  //!< Linear level of a brightness in 8.8 fixed point
 
 
 /***************************************< Types >**************************************/
@@ -36,8 +92,46 @@ typedef struct
   U8            u8Multiplexer;  //!< Multiplexer of the LED (1 or 2)
 } S_LED_DESCRIPTOR;
 
+//! \brief Precomputed port writes of a single soft-PWM slot
+typedef struct
+{
+  U32           u32GPIOA;       //!< Value to be written to the BSRR register of GPIOA
+  U32           u32GPIOB;       //!< Value to be written to the BSRR register of GPIOB
+} S_BITPLANE;
+
+#ifdef LED_MODE_SCHEDULED
+//! \brief Pin change event of the compare-scheduled driver
+typedef struct
+{
+  U8            u8Count;        //!< TIM16 count (PWM slot) when the pins change
+  S_BITPLANE    sWrites;        //!< Port writes of the change
+} S_LED_EVENT;
+#endif
+
 
 /***************************************< Constants >**************************************/
+//! \brief Gamma correction table: logical brightness -> linear duty cycle (255: always on), for engines of more than LED_LINEAR_LEVELS levels
+//! \note  Generated with round( 255 * ( x / 255 )^2.2 )
+CODE const U8 gcau8GammaTable[ LED_BRIGHTNESS_MAX + 1u ] =
+{
+    0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   0u,   1u,
+    1u,   1u,   1u,   1u,   1u,   1u,   1u,   1u,   1u,   2u,   2u,   2u,   2u,   2u,   2u,   2u,
+    3u,   3u,   3u,   3u,   3u,   4u,   4u,   4u,   4u,   5u,   5u,   5u,   5u,   6u,   6u,   6u,
+    6u,   7u,   7u,   7u,   8u,   8u,   8u,   9u,   9u,   9u,  10u,  10u,  11u,  11u,  11u,  12u,
+   12u,  13u,  13u,  13u,  14u,  14u,  15u,  15u,  16u,  16u,  17u,  17u,  18u,  18u,  19u,  19u,
+   20u,  20u,  21u,  22u,  22u,  23u,  23u,  24u,  25u,  25u,  26u,  26u,  27u,  28u,  28u,  29u,
+   30u,  30u,  31u,  32u,  33u,  33u,  34u,  35u,  35u,  36u,  37u,  38u,  39u,  39u,  40u,  41u,
+   42u,  43u,  43u,  44u,  45u,  46u,  47u,  48u,  49u,  49u,  50u,  51u,  52u,  53u,  54u,  55u,
+   56u,  57u,  58u,  59u,  60u,  61u,  62u,  63u,  64u,  65u,  66u,  67u,  68u,  69u,  70u,  71u,
+   73u,  74u,  75u,  76u,  77u,  78u,  79u,  81u,  82u,  83u,  84u,  85u,  87u,  88u,  89u,  90u,
+   91u,  93u,  94u,  95u,  97u,  98u,  99u, 100u, 102u, 103u, 105u, 106u, 107u, 109u, 110u, 111u,
+  113u, 114u, 116u, 117u, 119u, 120u, 121u, 123u, 124u, 126u, 127u, 129u, 130u, 132u, 133u, 135u,
+  137u, 138u, 140u, 141u, 143u, 145u, 146u, 148u, 149u, 151u, 153u, 154u, 156u, 158u, 159u, 161u,
+  163u, 165u, 166u, 168u, 170u, 172u, 173u, 175u, 177u, 179u, 181u, 182u, 184u, 186u, 188u, 190u,
+  192u, 194u, 196u, 197u, 199u, 201u, 203u, 205u, 207u, 209u, 211u, 213u, 215u, 217u, 219u, 221u,
+  223u, 225u, 227u, 229u, 231u, 234u, 236u, 238u, 240u, 242u, 244u, 246u, 248u, 251u, 253u, 255u
+};
+
 //! \brief Multiplexer pins
 static const S_PIN gcasMuxPins[ 2u ] =
 {
@@ -136,16 +230,375 @@ static const S_LED_DESCRIPTOR gcasLEDs[ LEDS_NUM ] =
 };
 
 
+#ifdef LED_MODE_BCM
+//! \brief Length of the BCM slots in timer ticks
+//! \note  The blanking slot makes a frame 16 ticks long, so the duty cycle is the same as with soft-PWM
+static const U8 gcau8SlotTicks[ PWM_SLOTS ] =
+{
+  1u,  // blanking, the multiplexer is switched here
+  1u,  // bit 0
+  2u,  // bit 1
+  4u,  // bit 2
+  8u   // bit 3
+};
+#endif
+
+
 /***************************************< Global variables >**************************************/
-DATA U8 gau8LEDBrightness[ LEDS_NUM ];  //!< Array for storing individual brightness levels
+DATA U8 gau8LEDBrightness[ LEDS_NUM ];  //!< Array for storing individual brightness levels [0; LED_BRIGHTNESS_MAX], shown after LED_Commit()
 DATA U8 gu8PWMCounter;                  //!< Counter for the base of soft-PWM
 DATA BIT gbitSide;                      //!< Stores which side of the panel is active
+#ifdef LED_MODE_BCM
+DATA U8 gu8LEDBitMask;                  //!< Brightness bit displayed in the running BCM slot
+#endif
+// Local variables
+static volatile DATA U8 gau8FrameBuffers[ 2u ][ LEDS_NUM ];  //!< Committed brightness levels: front and back buffer
+static volatile DATA U8 gu8FrontBuffer;             //!< Index of the buffer displayed by the driver, the other one is the back buffer
+static volatile DATA BIT gbitCommitPending;          //!< The back buffer holds a frame not displayed yet
+#ifdef LED_MODE_SCHEDULED
+static DATA S_LED_EVENT gasSchedule[ 2u ][ PWM_EVENTS ];  //!< Pin change events of both sides, ordered by time
+static DATA U8 gau8ScheduleLength[ 2u ];                  //!< Number of events in gasSchedule[] per side
+#else
+static DATA S_BITPLANE gasBitPlanes[ PWM_SLOTS ];   //!< Port writes of the active side, indexed by gu8PWMCounter
+static DATA BIT gbitStatic;                         //!< No LED of the side in gasBitPlanes[] is dimmed
+static DATA BIT gbitDark;                           //!< No LED of the side in gasBitPlanes[] is lit
+static DATA BIT gbitDarkBefore;                     //!< No LED of the side before it was lit
+static DATA BIT gbitMerged;                         //!< The PWM slots of the active side are merged into one timer period
+#ifdef LED_SKIP_DARK_SIDE
+static DATA BIT gbitSkipping;                       //!< The other side is dark, only the active side is displayed
+static DATA BIT gbitRoundUp;                        //!< Rounding of the halved levels while skipping, alternates in every frame
+#endif
+#endif
+static DATA S_BITPLANE gsLEDsOff;                   //!< Port writes that turn off every LED pin
+#ifdef LED_DITHERING
+static DATA U8 gau8DitherError[ LEDS_NUM ];         //!< Accumulated level fractions not displayed yet
+#endif
 
 
 /***************************************< Static function definitions >**************************************/
+static U32  MultiplexerWrites( U8 u8Side );
+static void SwapBuffers( void );
+#ifdef LED_MODE_SCHEDULED
+static void BuildSchedule( U8 u8Side );
+#else
+static void BuildBitPlanes( U8 u8Side );
+static U8   MergedTicks( void );
+#ifdef LED_SKIP_DARK_SIDE
+static BOOL SideIsDark( U8 u8Side );
+#endif
+#endif
+#ifdef LED_DITHERING
+static U8   DitheredLevel( U8 u8LEDIdx );
+#endif
 
 
 /***************************************< Private functions >**************************************/
+//----------------------------------------------------------------------------
+//! \brief  Calculates the GPIOA port write that selects one side of the multiplexer
+//! \param  u8Side: the side to be selected (value of gbitSide)
+//! \return Value for the BSRR register of GPIOA
+//! \global -
+//-----------------------------------------------------------------------------
+static U32 MultiplexerWrites( U8 u8Side )
+{
+  U32 u32Writes;
+  
+#ifdef LEDS_REVERSED
+  if( !u8Side )  // if left side
+#else  // normally populated LEDs
+  if( u8Side )  // if left side
+#endif
+  {
+    u32Writes  = gcasMuxPins[ 0u ].u32Pin;           // MPX1 set
+    u32Writes |= gcasMuxPins[ 1u ].u32Pin << 16u;    // MPX2 reset
+  }
+  else  // right side
+  {
+    u32Writes  = gcasMuxPins[ 0u ].u32Pin << 16u;    // MPX1 reset
+    u32Writes |= gcasMuxPins[ 1u ].u32Pin;           // MPX2 set
+  }
+  return u32Writes;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Takes over the last committed frame, if there is one
+//! \param  -
+//! \return -
+//! \global gu8FrontBuffer, gbitCommitPending
+//! \note   Called from the interrupt routine at frame boundary, before the first side is prepared.
+//-----------------------------------------------------------------------------
+static void SwapBuffers( void )
+{
+  if( gbitCommitPending )
+  {
+    gu8FrontBuffer ^= 1u;
+    gbitCommitPending = FALSE;
+  }
+#ifdef ANIMATION_IN_PENDSV
+  Animation_FrameInterrupt();  // the next frame can be computed while this one is displayed
+#endif
+}
+
+#ifdef LED_MODE_SCHEDULED
+//----------------------------------------------------------------------------
+//! \brief  Precalculates the pin change events of one side
+//! \param  u8Side: the side to be displayed next (value of gbitSide)
+//! \return -
+//! \global gasSchedule[], gau8ScheduleLength[], gsLEDsOff, gau8FrameBuffers[]
+//! \note   Called once per PWM frame, after the last pin change of the other side.
+//!         LEDs of the same brightness share an event, so there is one event per distinct level.
+//-----------------------------------------------------------------------------
+static void BuildSchedule( U8 u8Side )
+{
+  S_LED_EVENT* psEvents = gasSchedule[ u8Side ];
+  volatile U8* pu8Levels = gau8FrameBuffers[ gu8FrontBuffer ];
+  U8  u8Events = 1u;
+  U8  u8LEDIdx;
+  U8  u8EventIdx;
+  U8  u8Index;
+  U8  u8Level;
+  U32 u32Toggle;
+  
+  // Frame start: the multiplexer is switched and every LED is off by default
+  psEvents[ 0u ].u8Count = 0u;
+  psEvents[ 0u ].sWrites = gsLEDsOff;
+  psEvents[ 0u ].sWrites.u32GPIOA |= MultiplexerWrites( u8Side );
+  
+  for( u8LEDIdx = 0u; u8LEDIdx < LEDS_NUM; u8LEDIdx++ )
+  {
+    if( ( 1u + u8Side ) != gcasLEDs[ u8LEDIdx ].u8Multiplexer )
+    {
+      continue;  // not on this side
+    }
+    u8Level = LED_GammaLevel( pu8Levels[ u8LEDIdx ], PWM_MAX_LEVEL );
+    if( 0u == u8Level )
+    {
+      continue;  // stays dark
+    }
+    
+    // Swapping the set and reset bits of the pin turns it on at frame start
+    u32Toggle = gcasLEDs[ u8LEDIdx ].sPin.u32Pin | ( gcasLEDs[ u8LEDIdx ].sPin.u32Pin << 16u );
+    if( GPIOA == gcasLEDs[ u8LEDIdx ].sPin.psPort )
+    {
+      psEvents[ 0u ].sWrites.u32GPIOA ^= u32Toggle;
+    }
+    else
+    {
+      psEvents[ 0u ].sWrites.u32GPIOB ^= u32Toggle;
+    }
+    if( u8Level >= PWM_MAX_LEVEL )
+    {
+      continue;  // stays on for the whole frame
+    }
+    
+    // Find the event of this brightness level, or insert it in time order
+    for( u8EventIdx = 1u; ( u8EventIdx < u8Events ) && ( psEvents[ u8EventIdx ].u8Count < u8Level ); u8EventIdx++ );
+    if( ( u8EventIdx == u8Events ) || ( psEvents[ u8EventIdx ].u8Count != u8Level ) )
+    {
+      for( u8Index = u8Events; u8Index > u8EventIdx; u8Index-- )
+      {
+        psEvents[ u8Index ] = psEvents[ u8Index - 1u ];
+      }
+      psEvents[ u8EventIdx ].u8Count = u8Level;
+      psEvents[ u8EventIdx ].sWrites.u32GPIOA = 0u;
+      psEvents[ u8EventIdx ].sWrites.u32GPIOB = 0u;
+      u8Events++;
+    }
+    // Turn the pin off when its level is reached
+    if( GPIOA == gcasLEDs[ u8LEDIdx ].sPin.psPort )
+    {
+      psEvents[ u8EventIdx ].sWrites.u32GPIOA |= u32Toggle & gsLEDsOff.u32GPIOA;
+    }
+    else
+    {
+      psEvents[ u8EventIdx ].sWrites.u32GPIOB |= u32Toggle & gsLEDsOff.u32GPIOB;
+    }
+  }
+  gau8ScheduleLength[ u8Side ] = u8Events;
+}
+
+#else
+//----------------------------------------------------------------------------
+//! \brief  Precalculates the port writes of every PWM slot for one side
+//! \param  u8Side: the side to be displayed next (value of gbitSide)
+//! \return -
+//! \global gasBitPlanes[], gsLEDsOff, gau8FrameBuffers[], gbitStatic, gbitDark, gbitDarkBefore, gbitSkipping
+//! \note   Called once per PWM frame, right before the given side becomes active.
+//!         With LED_PHASE_STAGGER the on-windows of the LEDs are packed one after the other (wrapping around
+//!         the end of the frame), so at most one more LED is lit at any time than the average.
+//-----------------------------------------------------------------------------
+static void BuildBitPlanes( U8 u8Side )
+{
+#ifndef LED_DITHERING
+  volatile U8* pu8Levels = gau8FrameBuffers[ gu8FrontBuffer ];
+#endif
+  U8  u8LEDIdx;
+  U8  u8Slot;
+  U8  u8Level;
+  U32 u32Toggle;
+  U32* pu32Word;
+#ifdef LED_PHASE_STAGGER
+  U8  u8Offset = 0u;
+#endif
+  
+  // Every LED is off by default
+  for( u8Slot = 0u; u8Slot < PWM_SLOTS; u8Slot++ )
+  {
+    gasBitPlanes[ u8Slot ] = gsLEDsOff;
+  }
+  
+  // Multiplexer pins are switched together with the first slot
+  gasBitPlanes[ 0u ].u32GPIOA |= MultiplexerWrites( u8Side );
+  gbitDarkBefore = gbitDark;
+  gbitStatic = TRUE;
+  gbitDark = TRUE;
+  
+  // Turn on the LEDs of this side in the slots that belong to their brightness
+  for( u8LEDIdx = 0u; u8LEDIdx < LEDS_NUM; u8LEDIdx++ )
+  {
+    if( ( 1u + u8Side ) == gcasLEDs[ u8LEDIdx ].u8Multiplexer )
+    {
+#ifdef LED_DITHERING
+      u8Level = DitheredLevel( u8LEDIdx );
+#else
+      u8Level = LED_GammaLevel( pu8Levels[ u8LEDIdx ], PWM_MAX_LEVEL );
+#endif
+#ifdef LED_SKIP_DARK_SIDE
+      if( gbitSkipping )
+      {
+        u8Level = ( u8Level + gbitRoundUp ) >> 1u;  // the slots are twice as long
+      }
+#endif
+      if( 0u != u8Level )
+      {
+        gbitDark = FALSE;
+        if( PWM_MAX_LEVEL != u8Level )
+        {
+          gbitStatic = FALSE;
+        }
+      }
+      // Swapping the set and reset bits of the pin turns it from off to on
+      u32Toggle = gcasLEDs[ u8LEDIdx ].sPin.u32Pin | ( gcasLEDs[ u8LEDIdx ].sPin.u32Pin << 16u );
+      for( u8Slot = 0u; u8Slot < PWM_SLOTS; u8Slot++ )
+      {
+#ifdef LED_PHASE_STAGGER
+        if( SLOT_IS_ON( u8Level, SLOT_PHASE( u8Slot, u8Offset ) ) )
+#else
+        if( SLOT_IS_ON( u8Level, u8Slot ) )
+#endif
+        {
+          if( GPIOA == gcasLEDs[ u8LEDIdx ].sPin.psPort )
+          {
+            pu32Word = &gasBitPlanes[ u8Slot ].u32GPIOA;
+          }
+          else
+          {
+            pu32Word = &gasBitPlanes[ u8Slot ].u32GPIOB;
+          }
+          *pu32Word ^= u32Toggle;
+        }
+      }
+#ifdef LED_PHASE_STAGGER
+      // The next LED turns on where this one turns off, so the lit LEDs are spread evenly over the frame
+      u8Offset += u8Level;
+#endif
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Calculates the length of the timer period that displays a static side
+//! \param  -
+//! \return Timer ticks
+//! \global gbitDark, gbitDarkBefore
+//! \note   Only valid for sides without any dimmed LED, while the RGB LED is static too.
+//-----------------------------------------------------------------------------
+static U8 MergedTicks( void )
+{
+  U8 u8Ticks;
+  
+  if( gbitDark && gbitDarkBefore && RGBLED_IsDark() )  // nothing to display on any side
+  {
+    u8Ticks = LED_DARK_TICKS;
+  }
+  else  // the side is displayed for the same time as with PWM
+  {
+#ifdef LED_MODE_BCM
+    u8Ticks = PWM_LEVELS - gcau8SlotTicks[ 0u ];  // the blanking slot is kept
+#else
+    u8Ticks = PWM_SLOTS;
+#endif
+  }
+  return u8Ticks;
+}
+
+#ifdef LED_SKIP_DARK_SIDE
+//----------------------------------------------------------------------------
+//! \brief  Tells if every LED of a side is off
+//! \param  u8Side: the side to be checked (value of gbitSide)
+//! \return TRUE if no LED of the side is lit
+//! \global gau8FrameBuffers[]
+//-----------------------------------------------------------------------------
+static BOOL SideIsDark( U8 u8Side )
+{
+  volatile U8* pu8Levels = gau8FrameBuffers[ gu8FrontBuffer ];
+  BOOL bDark = TRUE;
+  U8   u8LEDIdx;
+  
+  for( u8LEDIdx = 0u; u8LEDIdx < LEDS_NUM; u8LEDIdx++ )
+  {
+    if( ( ( 1u + u8Side ) == gcasLEDs[ u8LEDIdx ].u8Multiplexer ) && ( 0u != pu8Levels[ u8LEDIdx ] ) )
+    {
+      bDark = FALSE;
+    }
+  }
+  return bDark;
+}
+#endif
+#endif
+
+#ifdef LED_DITHERING
+//----------------------------------------------------------------------------
+//! \brief  Calculates the PWM level of an LED for the next frame
+//! \param  u8LEDIdx: index of the LED
+//! \return PWM level [0; PWM_MAX_LEVEL]
+//! \global gau8FrameBuffers[], gau8DitherError[]
+//! \note   The fraction of the level is accumulated, and the next level is shown in every frame it carries over.
+//!         Must be called exactly once per frame for every LED of the displayed side.
+//-----------------------------------------------------------------------------
+static U8 DitheredLevel( U8 u8LEDIdx )
+{
+  U8  u8Brightness = gau8FrameBuffers[ gu8FrontBuffer ][ u8LEDIdx ];
+  U8  u8Fraction;
+  U16 u16Level;
+  
+  // PWM level in 8.8 fixed point, linear like LED_GammaLevel() on the 16 level engines
+  u16Level = LINEAR_LEVEL_8_8( u8Brightness );
+  if( LED_BRIGHTNESS_MAX == u8Brightness )
+  {
+    u16Level = (U16)PWM_MAX_LEVEL << 8u;  // fully lit stays fully lit
+  }
+  else if( ( 0u != u8Brightness ) && ( u16Level < DITHER_STEP ) )
+  {
+    u16Level = DITHER_STEP;  // the dimmest levels would be lost otherwise
+  }
+  
+  // Error diffusion over successive frames
+  u8Fraction = (U8)u16Level & (U8)( 0x100u - DITHER_STEP );
+  gau8DitherError[ u8LEDIdx ] += u8Fraction;
+  if( gau8DitherError[ u8LEDIdx ] < u8Fraction )  // carry
+  {
+    u16Level += 0x100u;
+  }
+  
+  u16Level >>= 8u;
+  if( u16Level > PWM_MAX_LEVEL )
+  {
+    u16Level = PWM_MAX_LEVEL;
+  }
+  return (U8)u16Level;
+}
+#endif
 
 
 /***************************************< Public functions >**************************************/
@@ -159,16 +612,64 @@ DATA BIT gbitSide;                      //!< Stores which side of the panel is a
 void LED_Init( void )
 {
   LL_GPIO_InitTypeDef TIM1CH1MapInit = {0};
-  U8 u8Index;
+#ifdef LED_MODE_SCHEDULED
+  LL_TIM_InitTypeDef TIM16CountInit = {0};
+#endif
+  U8  u8Index;
+  U32 u32OffWord;
   
   // Init globals
   gu8PWMCounter = 0;
   for( u8Index = 0; u8Index < LEDS_NUM; u8Index++ )
   {
     gau8LEDBrightness[ u8Index ] = 0;
+    gau8FrameBuffers[ 0u ][ u8Index ] = 0u;
+    gau8FrameBuffers[ 1u ][ u8Index ] = 0u;
+#ifdef LED_DITHERING
+    gau8DitherError[ u8Index ] = 0u;
+#endif
   }
+#ifdef USE_FULL_ASSERT
+  LED_AssertDistinctLevels( PWM_MAX_LEVEL );
+#endif
 
   gbitSide = 0u;
+  gu8FrontBuffer = 0u;
+#ifndef LED_MODE_SCHEDULED
+  gbitDark = TRUE;
+  gbitMerged = FALSE;
+#ifdef LED_SKIP_DARK_SIDE
+  gbitSkipping = FALSE;
+  gbitRoundUp = FALSE;
+#endif
+#endif
+  gbitCommitPending = FALSE;
+  
+  // Collect the port writes that turn off every LED pin
+  gsLEDsOff.u32GPIOA = 0u;
+  gsLEDsOff.u32GPIOB = 0u;
+  for( u8Index = 0; u8Index < LEDS_NUM; u8Index++ )
+  {
+#ifdef LEDS_REVERSED
+    u32OffWord = gcasLEDs[ u8Index ].sPin.u32Pin;          // set
+#else
+    u32OffWord = gcasLEDs[ u8Index ].sPin.u32Pin << 16u;  // reset
+#endif
+    if( GPIOA == gcasLEDs[ u8Index ].sPin.psPort )
+    {
+      gsLEDsOff.u32GPIOA |= u32OffWord;
+    }
+    else
+    {
+      gsLEDsOff.u32GPIOB |= u32OffWord;
+    }
+  }
+#ifdef LED_MODE_SCHEDULED
+  BuildSchedule( 0u );
+  BuildSchedule( 1u );
+#else
+  BuildBitPlanes( gbitSide );
+#endif
   
   // Enable clocks
   LL_IOP_GRP1_EnableClock( LL_IOP_GRP1_PERIPH_GPIOA );
@@ -192,72 +693,245 @@ void LED_Init( void )
   TIM1CH1MapInit.OutputType = LL_GPIO_OUTPUT_PUSHPULL;
   TIM1CH1MapInit.Speed      = LL_GPIO_SPEED_FREQ_VERY_HIGH;
   LL_GPIO_Init( GPIOB, &TIM1CH1MapInit );
+  
+#ifdef LED_MODE_SCHEDULED
+  // Initialize TIM16 base: one count per PWM level, one counter period per side
+  LL_APB1_GRP2_EnableClock( LL_APB1_GRP2_PERIPH_TIM16 );
+  TIM16CountInit.ClockDivision       = LL_TIM_CLOCKDIVISION_DIV1;
+  TIM16CountInit.CounterMode         = LL_TIM_COUNTERMODE_UP;
+  TIM16CountInit.Prescaler           = 150u - 1u;          // 6.25 usec, ~1.6 msec per side @ 24 MHz system clock
+  TIM16CountInit.Autoreload          = PWM_LEVELS - 1u;
+  TIM16CountInit.RepetitionCounter   = 0;
+  LL_TIM_Init( TIM16, &TIM16CountInit );
+  LL_TIM_OC_SetCompareCH1( TIM16, PWM_COUNT_NEVER );
+  
+  // Update interrupt at frame start, compare interrupt at pin changes
+  LL_TIM_EnableIT_UPDATE( TIM16 );
+  LL_TIM_EnableIT_CC1( TIM16 );
+  NVIC_EnableIRQ( TIM16_IRQn );
+  LL_TIM_EnableCounter( TIM16 );
+#endif
 }
 
+#ifdef LED_MODE_SCHEDULED
 //----------------------------------------------------------------------------
-//! \brief  Interrupt routine to implement soft-PWM
+//! \brief  Interrupt routine to implement compare-scheduled soft-PWM
 //! \param  -
 //! \return -
-//! \global gau8LEDBrightness[], gu8PWMCounter
-//! \note   Should be called from periodic timer interrupt routine.
+//! \global gasSchedule[], gu8PWMCounter, gbitSide
+//! \note   Should be called from the TIM16 interrupt routine.
+//!         Interrupts only at frame start and when a level is reached, not in every PWM slot.
 //-----------------------------------------------------------------------------
 void LED_Interrupt( void )
 {
-  U8 u8LEDIdx;
+  S_LED_EVENT* psEvents;
+  U8 u8NextCount;
   
-  // Increment counter and toggle multiplexer lines
-  gu8PWMCounter++;
-  if( gu8PWMCounter == PWM_LEVELS )
+  if( LL_TIM_IsActiveFlag_UPDATE( TIM16 ) )  // frame start
   {
-    gu8PWMCounter = 0;
+    LL_TIM_ClearFlag_UPDATE( TIM16 );
+    gu8PWMCounter = 0u;
     gbitSide ^= 1;
-    // Set multiplexer pins
-#ifdef LEDS_REVERSED
-    if( !gbitSide )  // if left side
-#else  // normally populated LEDs
-    if( gbitSide )  // if left side
-#endif
+  }
+  psEvents = gasSchedule[ gbitSide ];
+  
+  // Write out every event that is due, including the ones that passed while this interrupt was delayed
+  do
+  {
+    // One write per port changes all the pins of this event
+    WRITE_REG( GPIOA->BSRR, psEvents[ gu8PWMCounter ].sWrites.u32GPIOA );
+    WRITE_REG( GPIOB->BSRR, psEvents[ gu8PWMCounter ].sWrites.u32GPIOB );
+    gu8PWMCounter++;
+    
+    // Schedule the next pin change of this frame
+    if( gu8PWMCounter < gau8ScheduleLength[ gbitSide ] )
     {
-      LL_GPIO_SetOutputPin( gcasMuxPins[ 0u ].psPort, gcasMuxPins[ 0u ].u32Pin );    // MPX1
-      LL_GPIO_ResetOutputPin( gcasMuxPins[ 1u ].psPort, gcasMuxPins[ 1u ].u32Pin );  // MPX2
+      u8NextCount = psEvents[ gu8PWMCounter ].u8Count;
     }
-    else  // right side
+    else
+    {
+      u8NextCount = PWM_COUNT_NEVER;
+    }
+    LL_TIM_OC_SetCompareCH1( TIM16, u8NextCount );
+    LL_TIM_ClearFlag_CC1( TIM16 );
+  } while( LL_TIM_GetCounter( TIM16 ) >= u8NextCount );
+  
+  // Prepare the other side in the idle tail of this frame
+  if( PWM_COUNT_NEVER == u8NextCount )
+  {
+    if( gbitSide )  // both sides have been displayed
+    {
+      SwapBuffers();
+    }
+    BuildSchedule( !gbitSide );
+  }
+}
+
+#else
+//----------------------------------------------------------------------------
+//! \brief  Interrupt routine to implement soft-PWM
+//! \param  -
+//! \return -
+//! \global gasBitPlanes[], gu8PWMCounter, gbitSide, gbitMerged
+//! \note   Should be called from periodic timer interrupt routine, after Util_Interrupt().
+//!         It programs the length of the timer periods itself: a side without dimmed LEDs is displayed
+//!         with a single interrupt, and the interrupts are LED_DARK_TICKS apart while nothing is lit.
+//-----------------------------------------------------------------------------
+void LED_Interrupt( void )
+{
+  // Increment counter and toggle multiplexer side
+  gu8PWMCounter++;
+  if( gu8PWMCounter == PWM_SLOTS )
+  {
+    gu8PWMCounter = 0;
+#ifdef LED_SKIP_DARK_SIDE
+    if( !gbitSkipping )  // the same side is displayed again while the other one is skipped
+#endif
     {
-      LL_GPIO_ResetOutputPin( gcasMuxPins[ 0u ].psPort, gcasMuxPins[ 0u ].u32Pin );  // MPX1
-      LL_GPIO_SetOutputPin( gcasMuxPins[ 1u ].psPort, gcasMuxPins[ 1u ].u32Pin );    // MPX2
+      gbitSide ^= 1;
     }
   }
   
-  // Iterate through all the LEDs and set them according to the PWM duty cycles
-  for( u8LEDIdx = 0u; u8LEDIdx < LEDS_NUM; u8LEDIdx++ )
+  // One write per port sets all the LEDs (and the multiplexer) of this slot
+  WRITE_REG( GPIOA->BSRR, gasBitPlanes[ gu8PWMCounter ].u32GPIOA );
+  WRITE_REG( GPIOB->BSRR, gasBitPlanes[ gu8PWMCounter ].u32GPIOB );
+  
+#ifdef LED_MODE_BCM
+  gu8LEDBitMask = ( 0u == gu8PWMCounter ) ? 0u : (U8)( 1u << ( gu8PWMCounter - 1u ) );
+  // The timer latches the length of the next slot at the end of this one
+  if( gu8PWMCounter == ( PWM_SLOTS - 1u ) )
+  {
+    Util_SetNextPeriod( SLOT_TICKS( gcau8SlotTicks[ 0u ] ) );
+  }
+  else if( 0u == gu8PWMCounter )
+  {
+    // A static side is displayed by its first bit slot for the rest of the frame
+    gbitMerged = gbitStatic && RGBLED_IsStatic();
+    Util_SetNextPeriod( gbitMerged ? MergedTicks() : SLOT_TICKS( gcau8SlotTicks[ 1u ] ) );
+  }
+  else if( gbitMerged )  // the merged slot: the rest of the slots are skipped
+  {
+    gu8PWMCounter = PWM_SLOTS - 1u;
+    Util_SetNextPeriod( SLOT_TICKS( gcau8SlotTicks[ 0u ] ) );
+  }
+  else
   {
-    // If the LED is on the current side
-    if( ( 1u + gbitSide ) == gcasLEDs[ u8LEDIdx ].u8Multiplexer )
+    Util_SetNextPeriod( SLOT_TICKS( gcau8SlotTicks[ gu8PWMCounter + 1u ] ) );
+  }
+#else
+  // A static side is displayed by its first slot, the rest of the slots are skipped
+  if( gbitMerged )
+  {
+    gu8PWMCounter = PWM_SLOTS - 1u;
+  }
+#endif
+  
+  // Prepare the next frame after the last slot has been written out
+  if( gu8PWMCounter == ( PWM_SLOTS - 1u ) )
+  {
+#ifdef LED_SKIP_DARK_SIDE
+    if( gbitSide || gbitDark || gbitSkipping )  // a whole frame has been displayed, or the frame can be cut as nothing is lit
     {
-#ifdef LEDS_REVERSED
-      // Set or reset pin according to PWM duty cycle
-      if( gau8LEDBrightness[ u8LEDIdx ] > gu8PWMCounter )
-      {
-        LL_GPIO_ResetOutputPin( gcasLEDs[ u8LEDIdx ].sPin.psPort, gcasLEDs[ u8LEDIdx ].sPin.u32Pin );
-      }
-      else
-      {
-        LL_GPIO_SetOutputPin( gcasLEDs[ u8LEDIdx ].sPin.psPort, gcasLEDs[ u8LEDIdx ].sPin.u32Pin );
-      }
+      SwapBuffers();
+    }
+    // Slots can't be merged while the RGB LED is dimmed, but a dark side can be skipped:
+    // the other side is displayed at half level with slots twice as long, so there are half as many interrupts
+    gbitSkipping = !RGBLED_IsStatic() && SideIsDark( !gbitSide ) && !SideIsDark( gbitSide );
+    gbitRoundUp ^= 1;
+    BuildBitPlanes( gbitSkipping ? gbitSide : !gbitSide );
 #else
-      // Set or reset pin according to PWM duty cycle
-      if( gau8LEDBrightness[ u8LEDIdx ] > gu8PWMCounter )
-      {
-        LL_GPIO_SetOutputPin( gcasLEDs[ u8LEDIdx ].sPin.psPort, gcasLEDs[ u8LEDIdx ].sPin.u32Pin );
-      }
-      else
-      {
-        LL_GPIO_ResetOutputPin( gcasLEDs[ u8LEDIdx ].sPin.psPort, gcasLEDs[ u8LEDIdx ].sPin.u32Pin );
-      }
+    if( gbitSide || gbitDark )  // both sides have been displayed, or the frame can be cut as nothing is lit
+    {
+      SwapBuffers();
+    }
+    BuildBitPlanes( !gbitSide );
+#endif
+#ifndef LED_MODE_BCM
+    // The timer latches the length of the first slot of the next side at the end of this one
+    gbitMerged = gbitStatic && RGBLED_IsStatic();
+    Util_SetNextPeriod( gbitMerged ? MergedTicks() : SLOT_TICKS( 1u ) );
+#endif
+  }
+}
 #endif
+
+
+//----------------------------------------------------------------------------
+//! \brief  Hands the brightness levels over to the driver
+//! \param  -
+//! \return TRUE if committed, FALSE if the previous commit has not been displayed yet
+//! \global gau8LEDBrightness[], gau8FrameBuffers[], gbitCommitPending
+//! \note   The new levels are displayed from the next frame boundary, so a frame is never half-updated.
+//!         Should be called from main program only! Try again later if it returns FALSE.
+//-----------------------------------------------------------------------------
+BOOL LED_Commit( void )
+{
+  BOOL bReturn = FALSE;
+  U8   u8Index;
+  
+  if( !gbitCommitPending )  // the driver has taken the previous frame
+  {
+    for( u8Index = 0u; u8Index < LEDS_NUM; u8Index++ )
+    {
+      gau8FrameBuffers[ gu8FrontBuffer ^ 1u ][ u8Index ] = gau8LEDBrightness[ u8Index ];
     }
+    gbitCommitPending = TRUE;
+    bReturn = TRUE;
   }
+  return bReturn;
 }
 
+//----------------------------------------------------------------------------
+//! \brief  Converts a logical brightness to a gamma corrected PWM level
+//! \param  u8Brightness: logical brightness [0; LED_BRIGHTNESS_MAX]
+//! \param  u8MaxLevel: highest level of the PWM engine (fully lit)
+//! \return PWM level [0; u8MaxLevel], at least 1 for any lit LED
+//! \global gcau8GammaTable[]
+//! \note   Engines of up to LED_LINEAR_LEVELS levels are driven linearly: the gamma curve would merge their dim
+//!         levels. There each multiple of LED_LINEAR_STEP is its own level, LED_BRIGHTNESS_MAX is u8MaxLevel.
+//-----------------------------------------------------------------------------
+U8 LED_GammaLevel( U8 u8Brightness, U8 u8MaxLevel )
+{
+  U8 u8Level;
+  
+  if( LED_BRIGHTNESS_MAX == u8Brightness )
+  {
+    u8Level = u8MaxLevel;
+  }
+  else if( u8MaxLevel <= LED_LINEAR_LEVELS )
+  {
+    u8Level = (U8)( LINEAR_LEVEL_8_8( u8Brightness ) >> 8u );
+  }
+  else
+  {
+    u8Level = (U8)( ( (U16)gcau8GammaTable[ u8Brightness ] * ( u8MaxLevel + 1u ) ) >> 8u );
+  }
+  if( ( 0u == u8Level ) && ( 0u != u8Brightness ) )
+  {
+    u8Level = 1u;  // the dimmest levels would be lost otherwise
+  }
+  return u8Level;
+}
+
+#ifdef USE_FULL_ASSERT
+//----------------------------------------------------------------------------
+//! \brief  Checks that the animation levels stay distinct, increasing PWM levels on an engine
+//! \param  u8MaxLevel: highest level of the PWM engine (fully lit)
+//! \return -
+//! \global -
+//! \note   Any rising or falling sequence of animation levels has to stay strictly monotonic on the LEDs.
+//-----------------------------------------------------------------------------
+void LED_AssertDistinctLevels( U8 u8MaxLevel )
+{
+  U8 u8Level;
+  
+  for( u8Level = 1u; u8Level < LED_LINEAR_LEVELS; u8Level++ )
+  {
+    assert_param( LED_GammaLevel( (U8)( u8Level * LED_LINEAR_STEP ), u8MaxLevel ) >
+                  LED_GammaLevel( (U8)( ( u8Level - 1u ) * LED_LINEAR_STEP ), u8MaxLevel ) );
+  }
+}
+#endif
+
 
 /***************************************< End of file >**************************************/
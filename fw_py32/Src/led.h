@@ -12,25 +12,38 @@
 #define LED_H
 
 /***************************************< Includes >**************************************/
+#include "config.h"
 
 
 /***************************************< Definitions >**************************************/
 #define LEDS_NUM               (12u)  //!< Number of LEDs driven by this driver
+#define LED_BRIGHTNESS_MAX    (255u)  //!< Logical brightness of a fully lit LED
+#define LED_LINEAR_LEVELS      (16u)  //!< Engines with this many PWM levels or less are driven linearly, gamma would merge their dim levels
+#define LED_LINEAR_STEP       ( LED_BRIGHTNESS_MAX / ( LED_LINEAR_LEVELS - 1u ) )  //!< Logical brightness of one linear level, the animation levels are its multiples
 
 
 /***************************************< Types >**************************************/
 
 
 /***************************************< Constants >**************************************/
+extern CODE const U8 gcau8GammaTable[ LED_BRIGHTNESS_MAX + 1u ];
 
 
 /***************************************< Global variables >**************************************/
 extern DATA U8 gau8LEDBrightness[ LEDS_NUM ];
+#ifdef LED_MODE_BCM
+extern DATA U8 gu8LEDBitMask;
+#endif
 
 
 /***************************************< Public functions >**************************************/
 void LED_Init( void );
 void LED_Interrupt( void );
+BOOL LED_Commit( void );
+U8   LED_GammaLevel( U8 u8Brightness, U8 u8MaxLevel );
+#ifdef USE_FULL_ASSERT
+void LED_AssertDistinctLevels( U8 u8MaxLevel );
+#endif
 
 
 #endif /* LED_H */
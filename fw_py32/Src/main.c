@@ -94,6 +94,11 @@ static void PowerDown( void )
   LL_TIM_DisableCounter( TIM1 );
   LL_TIM_DisableAllOutputs( TIM1 );
   LL_APB1_GRP2_DisableClock( LL_APB1_GRP2_PERIPH_TIM1 );
+#ifdef LED_MODE_SCHEDULED
+  NVIC_DisableIRQ( TIM16_IRQn );
+  LL_TIM_DisableCounter( TIM16 );
+  LL_APB1_GRP2_DisableClock( LL_APB1_GRP2_PERIPH_TIM16 );
+#endif
   LL_GPIO_DeInit( GPIOA );
   LL_GPIO_DeInit( GPIOB );
   LL_GPIO_DeInit( GPIOF );
@@ -161,6 +166,9 @@ void main( void )
   // Start TIM1 update interrupts
   LL_TIM_EnableIT_UPDATE( TIM1 );
   NVIC_EnableIRQ( TIM1_BRK_UP_TRG_COM_IRQn );
+#ifdef ANIMATION_IN_PENDSV
+  NVIC_SetPriority( PendSV_IRQn, 3 );  // Lowest priority: the LED drivers preempt the animations
+#endif
 
   // Wait if the button is pressed on power up
   // This is necessary, to avoid changing animation on power on
@@ -172,6 +180,10 @@ void main( void )
 
   // Measure and show battery level
   BatteryLevel_Show();
+#ifdef ANIMATION_IN_PENDSV
+  // The first cycle schedules the next ones, they run from PendSV afterwards
+  Animation_Cycle();
+#endif
     
   // Main loop
   while( TRUE )
@@ -196,7 +208,7 @@ void main( void )
     switch( geButtonState )
     {
       case BUTTON_BOUNCING:   // The button just got pressed and it's currently bouncing
-        if( Util_GetTimerMs() == gu16ButtonPressTimer )  // the debounce timer has just went off
+        if( (I16)( Util_GetTimerMs() - gu16ButtonPressTimer ) >= 0 )  // the debounce timer has just went off
         {
           if( 0 == BUTTON_PIN )  // if the button is still pressed
           {
@@ -225,7 +237,7 @@ void main( void )
           // Save it
           Persist_Save();
         }
-        else if( Util_GetTimerMs() == gu16ButtonPressTimer )  // the long press timer has just went off
+        else if( (I16)( Util_GetTimerMs() - gu16ButtonPressTimer ) >= 0 )  // the long press timer has just went off
         {
           geButtonState = BUTTON_LONGPRESS;
           // Actions for long button press
@@ -245,7 +257,7 @@ void main( void )
         break;
       
       case BUTTON_RELEASING:  // The button just got released and it's currently bouncing
-        if( Util_GetTimerMs() == gu16ButtonPressTimer )  // the debounce timer has just went off
+        if( (I16)( Util_GetTimerMs() - gu16ButtonPressTimer ) >= 0 )  // the debounce timer has just went off
         {
           if( 1 == BUTTON_PIN )  // if the button is released
           {
@@ -273,9 +285,15 @@ void main( void )
         }
         break;
     }
+#ifdef ANIMATION_IN_PENDSV
+    // Sleep until the next housekeeping tick, the interrupts return to sleep meanwhile
+    LL_LPM_EnableSleepOnExit();
+    __WFI();  // Wait for interrupt instruction
+#else
     Animation_Cycle();
     // Sleep until next interrupt
     __WFI();  // Wait for interrupt instruction
+#endif
   }
 }
 
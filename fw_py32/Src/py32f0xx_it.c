@@ -27,6 +27,7 @@
 #include "util.h"
 #include "led.h"
 #include "rgbled.h"
+#include "animation.h"
 
 /* Private includes ----------------------------------------------------------*/
 
@@ -82,8 +83,12 @@ void SVC_Handler(void)
   */
 void PendSV_Handler(void)
 {
+#ifdef ANIMATION_IN_PENDSV
+  Animation_Cycle();  // Pended at PWM frame boundary when the animation is due, see Animation_FrameInterrupt()
+#else
   // This should not happen
   NVIC_SystemReset();
+#endif
 }
 
 /**
@@ -103,19 +108,33 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_py32f003xx.s).                   */
 /******************************************************************************/
 //----------------------------------------------------------------------------
-//! \brief  Timer 1 interrupt handler (10 kHz)
+//! \brief  Timer 1 interrupt handler (10 kHz, or less if the LED driver stretches the periods)
 //! \param  -
 //! \return -
 //-----------------------------------------------------------------------------
 void TIM1_BRK_UP_TRG_COM_IRQHandler( void )
 {
   Util_Interrupt();  // Housekeeping, e.g. ms delay timer
+#ifndef LED_MODE_SCHEDULED
   LED_Interrupt();  // Soft-PWM LED driver
+#endif
   RGBLED_Interrupt();  // RGB LED driver
   // End of interrupt
   LL_TIM_ClearFlag_UPDATE( TIM1 );
 }
 
+#ifdef LED_MODE_SCHEDULED
+//----------------------------------------------------------------------------
+//! \brief  Timer 16 interrupt handler (frame start and LED pin changes)
+//! \param  -
+//! \return -
+//-----------------------------------------------------------------------------
+void TIM16_IRQHandler( void )
+{
+  LED_Interrupt();  // Compare-scheduled LED driver, clears its own flags
+}
+#endif
+
 //----------------------------------------------------------------------------
 //! \brief  EXTI 3 interrupt handler
 //! \param  -
@@ -15,6 +15,9 @@
 
 // Own includes
 #include "types.h"
+#include "config.h"
+#include "util.h"
+#include "led.h"
 #include "rgbled.h"
 
 
@@ -24,6 +27,15 @@
 #define PWM_BRIGHT_GREEN   (18u)  //!< PWM duty cycle for bright color -- 1.5 us pulse
 #define PWM_BRIGHT_BLUE    (36u)  //!< PWM duty cycle for bright color -- 3 us pulse
 #define PWM_DARK            (0u)  //!< PWM duty cycle for darkness
+#ifdef LED_MODE_BCM
+#define COLOR_MAX_LEVEL    ( COLOR_LEVELS - 1u )                          //!< Highest level the BCM slots can display
+#define COLOR_IS_ON( u8Level )  ( 0u != ( (u8Level) & gu8LEDBitMask ) )  //!< Follow the BCM slots of the LED driver
+#define PERIOD_START       ( 0u == gu8LEDBitMask )                        //!< Blanking slot of the LED driver
+#else
+#define COLOR_MAX_LEVEL    COLOR_LEVELS                                   //!< Always on
+#define COLOR_IS_ON( u8Level )  ( (u8Level) > u8Cnt )                    //!< Soft-PWM with COLOR_LEVELS periods
+#define PERIOD_START       ( 0u == u8Cnt )
+#endif
 
 
 /***************************************< Types >**************************************/
@@ -34,8 +46,14 @@
 
 /***************************************< Global variables >**************************************/
 //! \brief Global array for RGB LED color values
-//! \note  Value set is between [0; COLOR_LEVELS)
+//! \note  Value set is between [0; LED_BRIGHTNESS_MAX], shown after RGBLED_Commit()
 volatile U8 gau8RGBLEDs[ NUM_RGBLED_COLORS ];
+// Local variables
+static volatile DATA U8 gau8BackBuffer[ NUM_RGBLED_COLORS ];  //!< Committed color values, not displayed yet
+static volatile DATA BIT gbitCommitPending;                   //!< The back buffer holds new colors
+static DATA U8 gau8ColorLevels[ NUM_RGBLED_COLORS ];  //!< Gamma corrected levels of the running PWM period
+static DATA BIT gbitStaticColors;                     //!< Every color is either fully on or off
+static DATA BIT gbitDarkColors;                       //!< Every color is off
 
 
 /***************************************< Static function definitions >**************************************/
@@ -59,6 +77,13 @@ void RGBLED_Init( void )
 
   // Initialize global variables
   memset( (U8*)gau8RGBLEDs, 0, NUM_RGBLED_COLORS );
+  memset( gau8ColorLevels, 0, NUM_RGBLED_COLORS );
+  gbitCommitPending = FALSE;
+  gbitStaticColors = TRUE;
+  gbitDarkColors = TRUE;
+#ifdef USE_FULL_ASSERT
+  LED_AssertDistinctLevels( COLOR_MAX_LEVEL );
+#endif
   
   // Enable clocks
   LL_APB1_GRP2_EnableClock( LL_APB1_GRP2_PERIPH_TIM1 );
@@ -105,15 +130,38 @@ void RGBLED_Init( void )
 //! \brief  Interrupt routine for timer-controlled RGB LED driver
 //! \param  -
 //! \return -
-//! \global gau8RGBLEDs
-//! \note   Should be called from periodic timer interrupt routine.
+//! \global gau8BackBuffer, gbitCommitPending, gau8ColorLevels
+//! \note   Should be called from periodic timer interrupt routine, after LED_Interrupt().
 //-----------------------------------------------------------------------------
 void RGBLED_Interrupt( void )
 {
+#ifndef LED_MODE_BCM
   static U8 u8Cnt = 0u;
+#endif
+  U8 u8Index;
+  
+  // Committed colors are taken over at the start of a PWM period, or anytime if there's no PWM running
+  if( ( PERIOD_START || gbitStaticColors ) && gbitCommitPending )
+  {
+    gbitStaticColors = TRUE;
+    gbitDarkColors = TRUE;
+    for( u8Index = 0u; u8Index < NUM_RGBLED_COLORS; u8Index++ )
+    {
+      gau8ColorLevels[ u8Index ] = LED_GammaLevel( gau8BackBuffer[ u8Index ], COLOR_MAX_LEVEL );
+      if( 0u != gau8ColorLevels[ u8Index ] )
+      {
+        gbitDarkColors = FALSE;
+        if( COLOR_MAX_LEVEL != gau8ColorLevels[ u8Index ] )
+        {
+          gbitStaticColors = FALSE;
+        }
+      }
+    }
+    gbitCommitPending = FALSE;
+  }
   
   // Red
-  if( gau8RGBLEDs[ 0 ] > u8Cnt )
+  if( COLOR_IS_ON( gau8ColorLevels[ 0 ] ) )
   {
     // Pulse for 1 usec
     LL_TIM_OC_SetCompareCH1( TIM1, PWM_BRIGHT_RED );
@@ -125,7 +173,7 @@ void RGBLED_Interrupt( void )
   }
   
   // Green
-  if( gau8RGBLEDs[ 1 ] > u8Cnt )
+  if( COLOR_IS_ON( gau8ColorLevels[ 1 ] ) )
   {
     // Pulse for 1 usec
     LL_TIM_OC_SetCompareCH4( TIM1, PWM_BRIGHT_GREEN );
@@ -137,7 +185,7 @@ void RGBLED_Interrupt( void )
   }
   
   // Blue
-  if( gau8RGBLEDs[ 2 ] > u8Cnt )
+  if( COLOR_IS_ON( gau8ColorLevels[ 2 ] ) )
   {
     // Pulse for 1 usec
     LL_TIM_OC_SetCompareCH3( TIM1, PWM_BRIGHT_BLUE );
@@ -147,11 +195,66 @@ void RGBLED_Interrupt( void )
     // No pulse
     LL_TIM_OC_SetCompareCH3( TIM1, PWM_DARK );
   }
+#ifndef LED_MODE_BCM
   u8Cnt++;
   if( COLOR_LEVELS <= u8Cnt )
   {
     u8Cnt = 0u;
   }
+#endif
+#ifdef LED_MODE_SCHEDULED
+  // The LEDs have their own timer, so this one only needs to run fast while the colors are dimmed
+  Util_SetNextPeriod( RGBLED_IsStatic() ? COLOR_LEVELS : 1u );
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+//! \brief  Hands the color values over to the driver
+//! \param  -
+//! \return TRUE if committed, FALSE if the previous commit has not been displayed yet
+//! \global gau8RGBLEDs, gau8BackBuffer, gbitCommitPending
+//! \note   Should be called from main program only! Try again later if it returns FALSE.
+//-----------------------------------------------------------------------------
+BOOL RGBLED_Commit( void )
+{
+  BOOL bReturn = FALSE;
+  U8   u8Index;
+  
+  if( !gbitCommitPending )  // the driver has taken the previous colors
+  {
+    for( u8Index = 0u; u8Index < NUM_RGBLED_COLORS; u8Index++ )
+    {
+      gau8BackBuffer[ u8Index ] = gau8RGBLEDs[ u8Index ];
+    }
+    gbitCommitPending = TRUE;
+    bReturn = TRUE;
+  }
+  return bReturn;
+}
+
+
+//----------------------------------------------------------------------------
+//! \brief  Tells if the RGB LED needs no PWM
+//! \param  -
+//! \return TRUE if every color is either fully on or off, and no new colors are waiting
+//! \global gbitStaticColors, gbitCommitPending
+//! \note   Used to lower the timer interrupt rate.
+//-----------------------------------------------------------------------------
+BOOL RGBLED_IsStatic( void )
+{
+  return gbitStaticColors && !gbitCommitPending;
+}
+
+//----------------------------------------------------------------------------
+//! \brief  Tells if the RGB LED is dark
+//! \param  -
+//! \return TRUE if every color is off, and no new colors are waiting
+//! \global gbitDarkColors, gbitCommitPending
+//-----------------------------------------------------------------------------
+BOOL RGBLED_IsDark( void )
+{
+  return gbitDarkColors && !gbitCommitPending;
 }
 
 
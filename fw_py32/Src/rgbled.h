@@ -32,6 +32,9 @@ extern volatile U8 gau8RGBLEDs[ NUM_RGBLED_COLORS ];
 /***************************************< Public functions >**************************************/
 void RGBLED_Init( void );
 void RGBLED_Interrupt( void );
+BOOL RGBLED_Commit( void );
+BOOL RGBLED_IsStatic( void );
+BOOL RGBLED_IsDark( void );
 
 
 #endif /* RGBLED_H */
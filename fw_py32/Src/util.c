@@ -71,6 +71,12 @@ CODE const U16 gcau16CRC16F3Table[] =
 //! \brief Globally accessible timer with millisecond resolution. IDATA for fast access.
 DATA U16 gu16TimerMS;
 DATA U8  gu8Prescaler;  //!< Prescaler for the global timer. IDATA for fast access.
+#ifdef ANIMATION_TICK_TIMEBASE
+//! \brief Globally accessible timer with 100 usec resolution, the timebase of the animations
+DATA U16 gu16TimerTicks;
+#endif
+static DATA U8 gu8PeriodTicks;      //!< Length of the timer period that ends with the next interrupt (in 100 usec ticks)
+static DATA U8 gu8NextPeriodTicks;  //!< Length of the timer period after that
 
 
 /***************************************< Static function definitions >**************************************/
@@ -119,14 +125,39 @@ char CODE* Util_Get_UID_ptr( void )
 //-----------------------------------------------------------------------------
 void Util_Interrupt( void )
 {
-  gu8Prescaler++;
-  if( gu8Prescaler >= 10u )
+  // Count the ticks of the timer period that has just ended
+#ifdef ANIMATION_TICK_TIMEBASE
+  gu16TimerTicks += gu8PeriodTicks;
+#endif
+  gu8Prescaler += gu8PeriodTicks;
+  gu8PeriodTicks = gu8NextPeriodTicks;
+  while( gu8Prescaler >= TIMER_TICKS_PER_MS )
   {
     gu16TimerMS++;
-    gu8Prescaler = 0u;
+    gu8Prescaler -= TIMER_TICKS_PER_MS;
+#ifdef ANIMATION_IN_PENDSV
+    if( 0u == ( gu16TimerMS & HOUSEKEEPING_MASK ) )
+    {
+      LL_LPM_DisableSleepOnExit();  // the main loop runs once after this interrupt
+    }
+#endif
   }
 }
 
+//----------------------------------------------------------------------------
+//! \brief  Sets the length of the timer period after the running one
+//! \param  u8Ticks: length of the period in 100 usec ticks [1; 255]
+//! \return -
+//! \global Timer period lengths
+//! \note   Runs in interrupt routine, after Util_Interrupt().
+//!         The timer latches the repetition counter at the end of the running period.
+//-----------------------------------------------------------------------------
+void Util_SetNextPeriod( U8 u8Ticks )
+{
+  gu8NextPeriodTicks = u8Ticks;
+  LL_TIM_SetRepetitionCounter( TIM1, u8Ticks - 1u );
+}
+
 //----------------------------------------------------------------------------
 //! \brief  Initialize global variables
 //! \param  -
@@ -138,6 +169,11 @@ void Util_Init( void )
 {
   gu8Prescaler = 0u;
   gu16TimerMS = 0u;
+#ifdef ANIMATION_TICK_TIMEBASE
+  gu16TimerTicks = 0u;
+#endif
+  gu8PeriodTicks = 1u;
+  gu8NextPeriodTicks = 1u;
 }
 
 //----------------------------------------------------------------------------
@@ -158,6 +194,27 @@ U16 Util_GetTimerMs( void )
   return u16Ret;
 }
 
+#ifdef ANIMATION_TICK_TIMEBASE
+//----------------------------------------------------------------------------
+//! \brief  Get global timer (100 usec ticks)
+//! \param  -
+//! \return Timer value, it wraps in 6.5 sec
+//! \global Global timer (ticks)
+//! \note   Should be called from main program only!
+//!         The value changes at the timer interrupts, which are at the PWM slot boundaries.
+//-----------------------------------------------------------------------------
+U16 Util_GetTimerTicks( void )
+{
+  U16 u16Ret;
+  
+  DISABLE_IT;
+  u16Ret = gu16TimerTicks;
+  ENABLE_IT;
+  
+  return u16Ret;
+}
+#endif
+
 //----------------------------------------------------------------------------
 //! \brief  Calculates CRC16 of given buffer
 //! \param  *pu8Buffer: given buffer
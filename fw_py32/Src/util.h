@@ -14,16 +14,19 @@
 /***************************************< Includes >**************************************/
 #include "main.h"
 #include "platform.h"
+#include "config.h"
 
 
 /***************************************< Definitions >**************************************/
 #define UID_LENGTH        (7u)  //!< Length of the unique ID of the MCU
 #define SYSTEM_CLOCK_MHZ (24u)  //!< System clock in MHz, rounded to integers
+#define TIMER_TICKS_PER_MS (10u)  //!< Timer interrupt periods (100 usec ticks) in a ms
+#define HOUSEKEEPING_MASK  (0x0Fu)  //!< The main loop is woken up in every 16 ms, if it sleeps on exit
 
 
 /***************************************< Macros >**************************************/
-#define DISABLE_IT     __enable_irq();   //!< Global interrupt disable
-#define ENABLE_IT      __disable_irq();  //!< Global interrupt enable
+#define DISABLE_IT     __disable_irq();  //!< Global interrupt disable
+#define ENABLE_IT      __enable_irq();   //!< Global interrupt enable
 
 
 /***************************************< Types >**************************************/
@@ -34,14 +37,21 @@
 
 /***************************************< Global variables >**************************************/
 extern DATA U16 gu16TimerMS;
+#ifdef ANIMATION_TICK_TIMEBASE
+extern DATA U16 gu16TimerTicks;
+#endif
 
 
 /***************************************< Public functions >**************************************/
 char CODE* Util_Get_UID_ptr( void );
 void Util_Get_UID( U8* pu8Dest );
 void Util_Interrupt( void );
+void Util_SetNextPeriod( U8 u8Ticks );
 void Util_Init( void );
 U16 Util_GetTimerMs( void );
+#ifdef ANIMATION_TICK_TIMEBASE
+U16 Util_GetTimerTicks( void );
+#endif
 U16 Util_CRC16( U8* pu8Buffer, U8 u8Length ) REENTRANT;
 
 